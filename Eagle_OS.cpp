@@ -1,742 +1,8931 @@
-#include <iostream>
-#include <string>
-#include <vector>
-#include <cstdlib>
-#include <ctime>
-#include <fstream>
-
-using namespace std;
-
-struct Process
-{
-    int process_id;
-    int AT;           // Arrival Time
-    int BT;           // Burst Time
-    int remainingBT;  // Remaining Burst Time for Round-Robin
-    int priority;     // Priority
-    int page_size;
-    int memory_allocated;
-    int process_size;
-    string state;
-    Process *next;
-};
-
-class ProcessManager
-{
-private:
-    Process *readyHead;
-    Process *runningHead;
-    Process *blockedHead;
-    int processCounter;
-    const int timeQuantum = 10; // Time quantum for Round-Robin
-    const int frameSize = 256;  // Frame size for paging
-    ofstream logFile;
-
-    // Utility function to delete a process from a list
-    void deleteProcess(Process *&head, Process *target)
-    {
-        if (!head)
-            return;
-        if (head == target)
-        {
-            Process *temp = head;
-            head = head->next;
-            delete temp;
-            return;
-        }
-        Process *prev = head;
-        while (prev->next && prev->next != target)
-            prev = prev->next;
-        if (prev->next)
-        {
-            Process *temp = prev->next;
-            prev->next = temp->next;
-            delete temp;
-        }
-    }
-
-    // Utility function to find a process in a list by ID
-    Process *findProcess(Process *head, int pid)
-    {
-        Process *temp = head;
-        while (temp && temp->process_id != pid)
-            temp = temp->next;
-        return temp;
-    }
-
-    // Utility function to move a process from one list to another
-    void moveProcess(Process *&from, Process *&to, int pid, const string &newState)
-    {
-        Process *process = findProcess(from, pid);
-        if (process)
-        {
-            logAction("Process " + to_string(process->process_id) + " moved to " + newState);
-            process->state = newState;
-            deleteProcess(from, process);
-            process->next = to;
-            to = process;
-        }
-    }
-
-    // Utility function to display a process list
-    void displayList(Process *head)
-    {
-        if (!head)
-        {
-            cout << "Queue is empty." << endl;
-            return;
-        }
-        cout << "Process ID\tArrival Time\tBurst Time\tRemaining BT\tPriority\tState" << endl;
-        while (head)
-        {
-            cout << head->process_id << "\t\t" << head->AT << "\t\t" << head->BT << "\t\t" << head->remainingBT << "\t\t" << head->priority << "\t\t" << head->state << endl;
-            head = head->next;
-        }
-    }
-
-    // Utility function to log actions
-    void logAction(const string &action)
-    {
-        time_t now = time(0);
-        string timestamp = ctime(&now);
-        timestamp.pop_back(); // Remove newline character
-        logFile << "[" << timestamp << "] " << action << endl;
-    }
-
-public:
-    ProcessManager() : readyHead(nullptr), runningHead(nullptr), blockedHead(nullptr), processCounter(0)
-    {
-        logFile.open("process_log.txt", ios::app);
-        if (!logFile)
-        {
-            cerr << "Unable to open log file." << endl;
-            exit(1);
-        }
-        logAction("Process Manager initialized.");
-    }
-
-    ~ProcessManager()
-    {
-        logAction("Process Manager terminated.");
-        logFile.close();
-    }
-
-    // Public utility functions for input validation
-    int getValidatedChoice(int min, int max)
-    {
-        int choice;
-        while (true)
-        {
-            cout << "Enter your choice (" << min << "-" << max << "): ";
-            cin >> choice;
-            if (cin.fail() || choice < min || choice > max)
-            {
-                cin.clear(); // clear input buffer to restore cin to a usable state
-                cin.ignore(INT_MAX, '\n'); // ignore last input
-                cout << "Invalid choice, please try again." << endl;
-            }
-            else
-            {
-                cin.ignore(INT_MAX, '\n'); // clear input buffer
-                break;
-            }
-        }
-        return choice;
-    }
-
-    int getValidatedProcessID()
-    {
-        int pid;
-        while (true)
-        {
-            cout << "Enter Process ID: ";
-            cin >> pid;
-            if (cin.fail() || pid <= 0)
-            {
-                cin.clear();
-                cin.ignore(INT_MAX, '\n');
-                cout << "Invalid Process ID, please try again." << endl;
-            }
-            else
-            {
-                cin.ignore(INT_MAX, '\n');
-                break;
-            }
-        }
-        return pid;
-    }
-
-    // Create a new process
-    void createProcess(int AT, int BT, int priority)
-    {
-        Process *newProcess = new Process{++processCounter, AT, BT, BT, priority, 0, 0, 0, "Ready", nullptr};
-        newProcess->next = readyHead;
-        readyHead = newProcess;
-        logAction("Created Process " + to_string(newProcess->process_id) + " with AT=" + to_string(AT) + ", BT=" + to_string(BT) + ", Priority=" + to_string(priority));
-    }
-
-    // Automatically create multiple processes with random values
-    void createMultipleProcesses(int numProcesses)
-    {
-        int AT, BT, priority;
-        for (int i = 0; i < numProcesses; i++)
-        {
-            AT = rand() % 100;
-            BT = rand() % 100;
-            priority = rand() % 10;
-            createProcess(AT, BT, priority);
-        }
-        logAction("Automatically created " + to_string(numProcesses) + " processes with random values.");
-    }
-
-    // Destroy a process
-    void destroyProcess(int pid)
-    {
-        Process *process = findProcess(readyHead, pid);
-        if (process)
-        {
-            deleteProcess(readyHead, process);
-            logAction("Destroyed Process " + to_string(pid));
-        }
-        else
-        {
-            cout << "Process ID " << pid << " not found." << endl;
-        }
-    }
-
-    // Change process priority
-    void changeProcessPriority(int pid, int newPriority)
-    {
-        Process *process = findProcess(readyHead, pid);
-        if (process)
-        {
-            process->priority = newPriority;
-            logAction("Changed priority of Process " + to_string(pid) + " to " + to_string(newPriority));
-            cout << "Priority of process " << pid << " has been changed to " << newPriority << endl;
-        }
-        else
-        {
-            cout << "Process ID " << pid << " not found." << endl;
-        }
-    }
-
-    // Process communication simulation
-    void processCommunication(int senderPid, int receiverPid, const string &message)
-    {
-        Process *sender = findProcess(readyHead, senderPid);
-        Process *receiver = findProcess(readyHead, receiverPid);
-
-        if (sender && receiver)
-        {
-            logAction("Process " + to_string(senderPid) + " communicated with Process " + to_string(receiverPid) + ": " + message);
-            cout << "Process " << senderPid << " sent a message to Process " << receiverPid << ": " << message << endl;
-        }
-        else
-        {
-            cout << "One or both process IDs not found." << endl;
-        }
-    }
-
-    // Suspend a process
-    void suspendProcess(int pid)
-    {
-        moveProcess(runningHead, readyHead, pid, "Suspended");
-    }
-
-    // Resume a process
-    void resumeProcess()
-    {
-        if (readyHead)
-        {
-            Process *toResume = readyHead; // Assume the first found process to be resumed
-            moveProcess(readyHead, runningHead, toResume->process_id, "Running");
-        }
-    }
-
-    // Block a process
-    void blockProcess(int pid)
-    {
-        moveProcess(runningHead, blockedHead, pid, "Blocked");
-    }
-
-    // Wake up a process
-    void wakeupProcess()
-    {
-        if (blockedHead)
-        {
-            Process *toWakeup = blockedHead; // Assume the first found process to be woken up
-            moveProcess(blockedHead, readyHead, toWakeup->process_id, "Ready");
-        }
-    }
-
-    // Dispatch a process
-    void dispatchProcess(int pid)
-    {
-        moveProcess(readyHead, runningHead, pid, "Running");
-    }
-
-    // First-Come-First-Serve (FCFS) scheduling
-    void fcfs()
-    {
-        if (!readyHead)
-            return;
-        Process *toRun = readyHead;
-        Process *prev = nullptr;
-        Process *curr = readyHead;
-        while (curr)
-        {
-            if (curr->AT < toRun->AT || (curr->AT == toRun->AT && curr->process_id < toRun->process_id))
-            {
-                toRun = curr;
-                prev = (prev == nullptr) ? readyHead : prev->next;
-            }
-            curr = curr->next;
-        }
-        dispatchProcess(toRun->process_id);
-    }
-
-    // Priority Scheduling
-    void priorityScheduling()
-    {
-        if (!readyHead)
-            return;
-        Process *toRun = readyHead;
-        Process *prev = nullptr;
-        Process *curr = readyHead;
-        while (curr)
-        {
-            if (curr->priority > toRun->priority || (curr->priority == toRun->priority && curr->AT < toRun->AT))
-            {
-                toRun = curr;
-                prev = (prev == nullptr) ? readyHead : prev->next;
-            }
-            curr = curr->next;
-        }
-        dispatchProcess(toRun->process_id);
-    }
-
-    // Shortest Job First (SJF) scheduling
-    void sjf()
-    {
-        if (!readyHead)
-            return;
-        Process *toRun = readyHead;
-        Process *prev = nullptr;
-        Process *curr = readyHead;
-        while (curr)
-        {
-            if (curr->BT < toRun->BT || (curr->BT == toRun->BT && curr->AT < toRun->AT))
-            {
-                toRun = curr;
-                prev = (prev == nullptr) ? readyHead : prev->next;
-            }
-            curr = curr->next;
-        }
-        dispatchProcess(toRun->process_id);
-    }
-
-    // Round-Robin (RR) scheduling
-    void roundRobin()
-    {
-        Process *curr = readyHead;
-        Process *prev = nullptr;
-        while (curr)
-        {
-            if (curr->remainingBT > timeQuantum)
-            {
-                curr->remainingBT -= timeQuantum;
-                prev = curr;
-                curr = curr->next;
-            }
-            else
-            {
-                dispatchProcess(curr->process_id);
-                curr = prev ? prev->next : readyHead;
-            }
-        }
-    }
-
-    // Multilevel Queue Scheduling
-    void multilevelQueueScheduling()
-    {
-        // High priority queue - Use Priority Scheduling
-        Process *highPriorityHead = nullptr;
-        // Low priority queue - Use Round-Robin Scheduling
-        Process *lowPriorityHead = nullptr;
-
-        // Split ready queue into high and low priority queues
-        Process *curr = readyHead;
-        while (curr)
-        {
-            if (curr->priority >= 5) // Arbitrary priority threshold
-            {
-                Process *next = curr->next;
-                curr->next = highPriorityHead;
-                highPriorityHead = curr;
-                curr = next;
-            }
-            else
-            {
-                Process *next = curr->next;
-                curr->next = lowPriorityHead;
-                lowPriorityHead = curr;
-                curr = next;
-            }
-        }
-
-        // Run Priority Scheduling on high priority queue
-        readyHead = highPriorityHead;
-        priorityScheduling();
-
-        // Run Round-Robin Scheduling on low priority queue
-        readyHead = lowPriorityHead;
-        roundRobin();
-
-        // Merge back the queues
-        if (!highPriorityHead)
-            readyHead = lowPriorityHead;
-        else
-        {
-            Process *tail = highPriorityHead;
-            while (tail->next)
-                tail = tail->next;
-            tail->next = lowPriorityHead;
-            readyHead = highPriorityHead;
-        }
-    }
-
-    // Perform Paging
-    void performPaging(int pid)
-    {
-        Process *process = findProcess(readyHead, pid);
-        if (process)
-        {
-            int numPages = (process->process_size + frameSize - 1) / frameSize;
-            cout << "Process " << pid << " requires " << numPages << " pages." << endl;
-            logAction("Performed paging for Process " + to_string(pid) + ": " + to_string(numPages) + " pages required.");
-        }
-        else
-        {
-            cout << "Process ID " << pid << " not found." << endl;
-        }
-    }
-
-    // Perform LRU page replacement simulation
-    void performLRU(int numFrames, vector<int> pageReferences)
-    {
-        vector<int> frames;
-        vector<pair<int, int>> pageTable; // Stores <page, time> to track usage
-
-        int time = 0;
-        for (int page : pageReferences)
-        {
-            time++;
-            bool found = false;
-
-            // Check if page is already in frames
-            for (int i = 0; i < frames.size(); i++)
-            {
-                if (frames[i] == page)
-                {
-                    pageTable[i].second = time; // Update the time of usage
-                    found = true;
-                    break;
-                }
-            }
-
-            if (!found)
-            {
-                if (frames.size() < numFrames)
-                {
-                    frames.push_back(page);
-                    pageTable.push_back({page, time});
-                }
-                else
-                {
-                    // Find the least recently used page
-                    int lruIndex = 0;
-                    for (int i = 1; i < pageTable.size(); i++)
-                    {
-                        if (pageTable[i].second < pageTable[lruIndex].second)
-                        {
-                            lruIndex = i;
-                        }
-                    }
-
-                    frames[lruIndex] = page;
-                    pageTable[lruIndex] = {page, time};
-                }
-
-                logAction("Page " + to_string(page) + " added to frames.");
-            }
-        }
-
-        cout << "Final frame contents: ";
-        for (int frame : frames)
-            cout << frame << " ";
-        cout << endl;
-    }
-
-    // Set page size for a process
-    void setPageSize(int pid, int pageSize)
-    {
-        Process *process = findProcess(readyHead, pid);
-        if (process)
-        {
-            process->page_size = pageSize;
-            logAction("Page size of process " + to_string(pid) + " set to " + to_string(pageSize));
-            cout << "Page size of process " << pid << " has been set to " << pageSize << endl;
-        }
-        else
-        {
-            cout << "Process ID " << pid << " not found." << endl;
-        }
-    }
-
-    // Calculate number of pages required
-    void calculatePages(int pid, int memoryAllocated, int processSize)
-    {
-        Process *process = findProcess(readyHead, pid);
-        if (process)
-        {
-            process->memory_allocated = memoryAllocated;
-            process->process_size = processSize;
-
-            int numberOfPages = process->memory_allocated / process->page_size;
-            int numberOfFrames = process->process_size / process->page_size;
-            int numberOfEntries = numberOfPages * numberOfFrames;
-
-            logAction("Calculated pages for process " + to_string(pid));
-            cout << "Memory needed for process " << pid << " is " << memoryAllocated << endl;
-            cout << "Number of pages in the process: " << numberOfPages << endl;
-            cout << "Number of frames in memory for process " << pid << " : " << numberOfFrames << endl;
-            cout << "Number of entries: " << numberOfEntries << endl;
-        }
-        else
-        {
-            cout << "Process ID " << pid << " not found." << endl;
-        }
-    }
-
-    // Display all queues
-    void displayAll()
-    {
-        cout << "Ready Queue:" << endl;
-        displayList(readyHead);
-        cout << "Running Queue:" << endl;
-        displayList(runningHead);
-        cout << "Blocked Queue:" << endl;
-        displayList(blockedHead);
-    }
-};
-
-int main()
-{
-    srand(time(0));
-    ProcessManager pm;
-
-    while (true)
-    {
-        cout << "Main Menu:" << endl;
-        cout << "1. Process Management" << endl;
-        cout << "2. Memory Management" << endl;
-        cout << "3. Automatically Add Processes" << endl;
-        cout << "4. Exit" << endl;
-        int choice = pm.getValidatedChoice(1, 4);
-
-        switch (choice)
-        {
-        case 1:
-        {
-            while (true)
-            {
-                cout << "Process Management Menu:" << endl;
-                cout << "1. Create a process" << endl;
-                cout << "2. Destroy a process" << endl;
-                cout << "3. Suspend a process" << endl;
-                cout << "4. Resume a process" << endl;
-                cout << "5. Block a process" << endl;
-                cout << "6. Wake up a process" << endl;
-                cout << "7. Dispatch a process" << endl;
-                cout << "8. Change process priority" << endl;
-                cout << "9. Process communication" << endl;
-                cout << "10. First-Come-First-Serve (FCFS) Scheduling" << endl;
-                cout << "11. Priority Scheduling" << endl;
-                cout << "12. Shortest Job First (SJF) Scheduling" << endl;
-                cout << "13. Round-Robin (RR) Scheduling" << endl;
-                cout << "14. Multilevel Queue Scheduling" << endl;
-                cout << "15. Back to Main Menu" << endl;
-                int pmChoice = pm.getValidatedChoice(1, 15);
-
-                if (pmChoice == 1)
-                {
-                    int numProcesses, AT, BT, priority;
-                    cout << "Enter number of processes: ";
-                    cin >> numProcesses;
-                    for (int i = 0; i < numProcesses; i++)
-                    {
-                        AT = rand() % 100;
-                        BT = rand() % 100;
-                        priority = rand() % 10;
-                        pm.createProcess(AT, BT, priority);
-                    }
-                    pm.displayAll();
-                }
-                else if (pmChoice == 2)
-                {
-                    int pid = pm.getValidatedProcessID();
-                    pm.destroyProcess(pid);
-                    pm.displayAll();
-                }
-                else if (pmChoice == 3)
-                {
-                    int pid = pm.getValidatedProcessID();
-                    pm.suspendProcess(pid);
-                    pm.displayAll();
-                }
-                else if (pmChoice == 4)
-                {
-                    pm.resumeProcess();
-                    pm.displayAll();
-                }
-                else if (pmChoice == 5)
-                {
-                    int pid = pm.getValidatedProcessID();
-                    pm.blockProcess(pid);
-                    pm.displayAll();
-                }
-                else if (pmChoice == 6)
-                {
-                    pm.wakeupProcess();
-                    pm.displayAll();
-                }
-                else if (pmChoice == 7)
-                {
-                    int pid = pm.getValidatedProcessID();
-                    pm.dispatchProcess(pid);
-                    pm.displayAll();
-                }
-                else if (pmChoice == 8)
-                {
-                    int pid = pm.getValidatedProcessID();
-                    int newPriority;
-                    cout << "Enter new priority: ";
-                    cin >> newPriority;
-                    pm.changeProcessPriority(pid, newPriority);
-                    pm.displayAll();
-                }
-                else if (pmChoice == 9)
-                {
-                    int senderPid = pm.getValidatedProcessID();
-                    int receiverPid = pm.getValidatedProcessID();
-                    string message;
-                    cout << "Enter message to send: ";
-                    cin.ignore(); // To clear the newline left in the input buffer
-                    getline(cin, message);
-                    pm.processCommunication(senderPid, receiverPid, message);
-                    pm.displayAll();
-                }
-                else if (pmChoice == 10)
-                {
-                    pm.fcfs();
-                    pm.displayAll();
-                }
-                else if (pmChoice == 11)
-                {
-                    pm.priorityScheduling();
-                    pm.displayAll();
-                }
-                else if (pmChoice == 12)
-                {
-                    pm.sjf();
-                    pm.displayAll();
-                }
-                else if (pmChoice == 13)
-                {
-                    pm.roundRobin();
-                    pm.displayAll();
-                }
-                else if (pmChoice == 14)
-                {
-                    pm.multilevelQueueScheduling();
-                    pm.displayAll();
-                }
-                else if (pmChoice == 15)
-                {
-                    break;
-                }
-            }
-            break;
-        }
-        case 2:
-        {
-            while (true)
-            {
-                cout << "Memory Management Menu:" << endl;
-                cout << "1. Set Page Size" << endl;
-                cout << "2. Calculate Pages" << endl;
-                cout << "3. Perform Paging" << endl;
-                cout << "4. Perform LRU" << endl;
-                cout << "5. Back to Main Menu" << endl;
-                int mmChoice = pm.getValidatedChoice(1, 5);
-
-                if (mmChoice == 1)
-                {
-                    int pid = pm.getValidatedProcessID();
-                    int pageSize;
-                    cout << "Enter Page Size: ";
-                    cin >> pageSize;
-                    pm.setPageSize(pid, pageSize);
-                }
-                else if (mmChoice == 2)
-                {
-                    int pid = pm.getValidatedProcessID();
-                    int memoryAllocated, processSize;
-                    cout << "Enter Memory Size: ";
-                    cin >> memoryAllocated;
-                    cout << "Enter Process Size: ";
-                    cin >> processSize;
-                    pm.calculatePages(pid, memoryAllocated, processSize);
-                }
-                else if (mmChoice == 3)
-                {
-                    int pid = pm.getValidatedProcessID();
-                    pm.performPaging(pid);
-                }
-                else if (mmChoice == 4)
-                {
-                    int numFrames;
-                    int numReferences;
-                    vector<int> pageReferences;
-                    cout << "Enter number of frames: ";
-                    cin >> numFrames;
-                    cout << "Enter number of page references: ";
-                    cin >> numReferences;
-                    pageReferences.resize(numReferences);
-                    cout << "Enter page references: ";
-                    for (int i = 0; i < numReferences; i++)
-                        cin >> pageReferences[i];
-                    pm.performLRU(numFrames, pageReferences);
-                }
-                else if (mmChoice == 5)
-                {
-                    break;
-                }
-            }
-            break;
-        }
-        case 3:
-        {
-            int numProcesses;
-            cout << "Enter number of processes to add: ";
-            cin >> numProcesses;
-            pm.createMultipleProcesses(numProcesses);
-            pm.displayAll();
-            break;
-        }
-        case 4:
-            cout << "Exit" << endl;
-            return 0;
-        }
-    }
-}
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <ctime>
+#include <climits>
+#include <fstream>
+#include <sstream>
+#include <cctype>
+#include <memory>
+#include <deque>
+#include <queue>
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <random>
+#include <cmath>
+#include <cstdio>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define EAGLE_X86_SIMD
+#include <immintrin.h>
+#endif
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Log levels; records below the logger's level are dropped
+enum LogLevel
+{
+    LOG_DEBUG, // Per-process transitions on hot paths
+    LOG_INFO,  // Operations requested by the user
+    LOG_WARN,
+    LOG_ERROR,
+    LOG_OFF
+};
+
+// Records below this level are compiled out of logEnabled() checks
+#ifndef EAGLE_MIN_LOG_LEVEL
+#define EAGLE_MIN_LOG_LEVEL LOG_DEBUG
+#endif
+
+// Asynchronous file logger. Producers copy records into a bounded lock-free
+// ring (Vyukov's multi-producer queue) without allocating or touching the
+// file; a background thread drains the ring, formats the timestamps (cached
+// per second) and writes each batch with a single write call.
+class AsyncLogger
+{
+private:
+    static const size_t RING_SIZE = 8192; // Power of two
+    static const size_t MAX_MESSAGE = 240;
+
+    struct Record
+    {
+        atomic<size_t> sequence;
+        time_t when;
+        unsigned short length;
+        char text[MAX_MESSAGE];
+    };
+
+    unique_ptr<Record[]> ring;
+    atomic<size_t> enqueuePos;
+    atomic<size_t> dequeuePos;
+    atomic<int> level;
+    atomic<bool> stopping;
+    atomic<unsigned long long> bytesWritten;
+    ofstream file;
+    thread writer;
+    mutex wakeMutex;
+    condition_variable wake;
+
+    time_t cachedSecond;
+    string cachedStamp;
+
+    const string &timestamp(time_t when)
+    {
+        if (when != cachedSecond)
+        {
+            cachedSecond = when;
+            cachedStamp = ctime(&when);
+            cachedStamp.pop_back(); // Remove newline character
+        }
+        return cachedStamp;
+    }
+
+    // Move every published record into one buffer and write it out
+    size_t drain(string &batch)
+    {
+        size_t pos = dequeuePos.load(memory_order_relaxed);
+        size_t count = 0;
+        batch.clear();
+        while (true)
+        {
+            Record &record = ring[pos & (RING_SIZE - 1)];
+            if (record.sequence.load(memory_order_acquire) != pos + 1)
+                break;
+            batch += '[';
+            batch += timestamp(record.when);
+            batch += "] ";
+            batch.append(record.text, record.length);
+            batch += '\n';
+            record.sequence.store(pos + RING_SIZE, memory_order_release);
+            pos++;
+            count++;
+        }
+        if (count)
+        {
+            dequeuePos.store(pos, memory_order_release);
+            file.write(batch.data(), batch.size());
+            file.flush();
+            bytesWritten.fetch_add(batch.size(), memory_order_relaxed);
+        }
+        return count;
+    }
+
+    void run()
+    {
+        string batch;
+        batch.reserve(RING_SIZE * 64);
+        while (!stopping.load(memory_order_acquire))
+        {
+            if (drain(batch) == 0)
+            {
+                unique_lock<mutex> lock(wakeMutex);
+                wake.wait_for(lock, chrono::milliseconds(20));
+            }
+        }
+        while (drain(batch) > 0)
+            ;
+    }
+
+public:
+    AsyncLogger()
+        : ring(new Record[RING_SIZE]), enqueuePos(0), dequeuePos(0), level(LOG_DEBUG), stopping(false), bytesWritten(0), cachedSecond(-1)
+    {
+        for (size_t i = 0; i < RING_SIZE; i++)
+            ring[i].sequence.store(i, memory_order_relaxed);
+    }
+
+    ~AsyncLogger() { close(); }
+
+    bool open(const string &path)
+    {
+        file.open(path.c_str(), ios::app | ios::binary);
+        if (!file)
+            return false;
+        writer = thread(&AsyncLogger::run, this);
+        return true;
+    }
+
+    // Stop the writer after everything queued so far has been written
+    void close()
+    {
+        if (!writer.joinable())
+            return;
+        stopping.store(true, memory_order_release);
+        wake.notify_one();
+        writer.join();
+        file.close();
+    }
+
+    void setLevel(LogLevel newLevel) { level.store(newLevel, memory_order_relaxed); }
+    LogLevel getLevel() const { return (LogLevel)level.load(memory_order_relaxed); }
+    bool enabled(LogLevel recordLevel) const { return recordLevel >= EAGLE_MIN_LOG_LEVEL && recordLevel >= level.load(memory_order_relaxed); }
+    unsigned long long bytesLogged() const { return bytesWritten.load(memory_order_relaxed); }
+
+    // Queue a record; messages longer than MAX_MESSAGE are truncated.
+    // Blocks only while the ring is full.
+    void log(LogLevel recordLevel, const char *message, size_t length)
+    {
+        if (!enabled(recordLevel) || !writer.joinable())
+            return;
+        size_t pos = enqueuePos.load(memory_order_relaxed);
+        Record *record;
+        while (true)
+        {
+            record = &ring[pos & (RING_SIZE - 1)];
+            size_t sequence = record->sequence.load(memory_order_acquire);
+            intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+            if (diff == 0)
+            {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // Ring full: let the writer catch up
+                wake.notify_one();
+                this_thread::yield();
+                pos = enqueuePos.load(memory_order_relaxed);
+            }
+            else
+                pos = enqueuePos.load(memory_order_relaxed);
+        }
+        record->when = time(0);
+        record->length = (unsigned short)min(length, MAX_MESSAGE);
+        memcpy(record->text, message, record->length);
+        record->sequence.store(pos + 1, memory_order_release);
+    }
+
+    void log(LogLevel recordLevel, const string &message) { log(recordLevel, message.data(), message.size()); }
+
+    // Wait until every record queued before the call has been written
+    void flush()
+    {
+        size_t target = enqueuePos.load(memory_order_acquire);
+        while (writer.joinable() && dequeuePos.load(memory_order_acquire) < target)
+        {
+            wake.notify_one();
+            this_thread::yield();
+        }
+    }
+};
+
+// State transitions recorded in a binary trace
+enum TraceEventType
+{
+    TRACE_CREATE,     // payload: AT, BT, priority
+    TRACE_DESTROY,
+    TRACE_MOVE,       // payload: from queue, to queue (simulator adds remaining BT)
+    TRACE_DISPATCH,   // payload: from queue, to queue (simulator adds slice length, cpu)
+    TRACE_SUSPEND,    // payload: from queue, to queue
+    TRACE_BLOCK,      // payload: from queue, to queue
+    TRACE_WAKEUP,     // payload: from queue, to queue
+    TRACE_PRIORITY,   // payload: old priority, new priority
+    TRACE_PAGE_FAULT, // payload: page, reference index low and high 32 bits (time is the reference index)
+    TRACE_COMPLETE,   // Simulator job finished
+    TRACE_EVENT_COUNT
+};
+
+// Queue identifiers used in trace payloads
+enum TraceQueue
+{
+    TRACE_QUEUE_NONE,
+    TRACE_QUEUE_READY,
+    TRACE_QUEUE_RUNNING,
+    TRACE_QUEUE_BLOCKED
+};
+
+// Fixed-size trace record; times are simulated ticks (operation sequence
+// numbers when recorded by ProcessManager)
+struct TraceRecord
+{
+    uint16_t type;
+    uint16_t reserved;
+    int32_t pid;
+    int64_t time;
+    int32_t payload[4];
+};
+
+struct TraceHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+};
+
+const char TRACE_MAGIC[8] = {'E', 'G', 'L', 'T', 'R', 'A', 'C', 'E'};
+const uint32_t TRACE_VERSION = 1;
+
+// Buffered appender for binary traces. Records fill one buffer while a
+// background thread writes the previous one, so recording is a plain store
+// and the file I/O overlaps with the simulation.
+class TraceWriter
+{
+private:
+    static const size_t BUFFER_RECORDS = 1 << 16;
+    ofstream file;
+    vector<TraceRecord> filling;
+    vector<TraceRecord> writing;
+    bool pending;  // writing holds records not yet on disk
+    bool stopping;
+    thread writer;
+    mutex lock;
+    condition_variable changed;
+
+    void run()
+    {
+        unique_lock<mutex> guard(lock);
+        while (true)
+        {
+            changed.wait(guard, [this] { return pending || stopping; });
+            if (!pending)
+                return;
+            guard.unlock();
+            file.write((const char *)writing.data(), writing.size() * sizeof(TraceRecord));
+            guard.lock();
+            writing.clear();
+            pending = false;
+            changed.notify_all();
+        }
+    }
+
+    // Hand the filled buffer to the writer thread
+    void submit()
+    {
+        unique_lock<mutex> guard(lock);
+        changed.wait(guard, [this] { return !pending; });
+        filling.swap(writing);
+        pending = true;
+        changed.notify_all();
+    }
+
+public:
+    TraceWriter() : pending(false), stopping(false)
+    {
+        filling.reserve(BUFFER_RECORDS);
+        writing.reserve(BUFFER_RECORDS);
+    }
+    ~TraceWriter() { close(); }
+
+    bool open(const string &path)
+    {
+        file.open(path.c_str(), ios::binary | ios::trunc);
+        if (!file)
+            return false;
+        TraceHeader header;
+        memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+        header.version = TRACE_VERSION;
+        header.recordSize = sizeof(TraceRecord);
+        file.write((const char *)&header, sizeof(header));
+        writer = thread(&TraceWriter::run, this);
+        return (bool)file;
+    }
+
+    void record(TraceEventType type, int pid, long long time, int p0 = 0, int p1 = 0, int p2 = 0, int p3 = 0)
+    {
+        TraceRecord r;
+        r.type = (uint16_t)type;
+        r.reserved = 0;
+        r.pid = pid;
+        r.time = time;
+        r.payload[0] = p0;
+        r.payload[1] = p1;
+        r.payload[2] = p2;
+        r.payload[3] = p3;
+        filling.push_back(r);
+        if (filling.size() == BUFFER_RECORDS)
+            submit();
+    }
+
+    // Write out everything recorded so far
+    void flush()
+    {
+        if (!writer.joinable())
+            return;
+        if (!filling.empty())
+            submit();
+        unique_lock<mutex> guard(lock);
+        changed.wait(guard, [this] { return !pending; });
+        file.flush();
+    }
+
+    void close()
+    {
+        if (!writer.joinable())
+            return;
+        flush();
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        changed.notify_all();
+        writer.join();
+        file.close();
+    }
+};
+
+const char *traceQueueState(int queue)
+{
+    static const char *states[] = {"None", "Ready", "Running", "Blocked"};
+    return queue >= 0 && queue <= TRACE_QUEUE_BLOCKED ? states[queue] : "Unknown";
+}
+
+const char *traceEventName(int type)
+{
+    static const char *names[TRACE_EVENT_COUNT] = {"create", "destroy", "move", "dispatch", "suspend", "block", "wakeup", "priority", "page_fault", "complete"};
+    return type >= 0 && type < TRACE_EVENT_COUNT ? names[type] : "unknown";
+}
+
+// Render a trace record as the line process_log.txt would carry for it
+string describeTraceRecord(const TraceRecord &r)
+{
+    string pid = to_string(r.pid);
+    switch (r.type)
+    {
+    case TRACE_CREATE:
+        return "Created Process " + pid + " with AT=" + to_string(r.payload[0]) + ", BT=" + to_string(r.payload[1]) + ", Priority=" + to_string(r.payload[2]);
+    case TRACE_DESTROY:
+        return "Destroyed Process " + pid;
+    case TRACE_MOVE:
+    case TRACE_DISPATCH:
+    case TRACE_BLOCK:
+    case TRACE_WAKEUP:
+        return "Process " + pid + " moved to " + traceQueueState(r.payload[1]);
+    case TRACE_SUSPEND:
+        return "Process " + pid + " moved to Suspended";
+    case TRACE_PRIORITY:
+        return "Changed priority of Process " + pid + " to " + to_string(r.payload[1]);
+    case TRACE_PAGE_FAULT:
+        return "Page " + to_string(r.payload[0]) + " added to frames.";
+    case TRACE_COMPLETE:
+        return "Process " + pid + " completed";
+    default:
+        return "Unknown event " + to_string(r.type) + " for Process " + pid;
+    }
+}
+
+// Decode a binary trace to stdout as log lines or CSV
+bool decodeTrace(const string &path, bool csv)
+{
+    ifstream in(path.c_str(), ios::binary);
+    TraceHeader header;
+    if (!in.read((char *)&header, sizeof(header)) || memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0)
+    {
+        cerr << "Not a trace file: " << path << endl;
+        return false;
+    }
+    if (header.version != TRACE_VERSION || header.recordSize != sizeof(TraceRecord))
+    {
+        cerr << "Unsupported trace version " << header.version << endl;
+        return false;
+    }
+
+    if (csv)
+        cout << "time,event,pid,payload0,payload1,payload2,payload3\n";
+    vector<TraceRecord> block(8192);
+    while (in)
+    {
+        in.read((char *)block.data(), block.size() * sizeof(TraceRecord));
+        size_t count = in.gcount() / sizeof(TraceRecord);
+        for (size_t i = 0; i < count; i++)
+        {
+            const TraceRecord &r = block[i];
+            if (csv)
+                cout << r.time << ',' << traceEventName(r.type) << ',' << r.pid << ',' << r.payload[0] << ',' << r.payload[1] << ',' << r.payload[2] << ',' << r.payload[3] << '\n';
+            else
+                cout << "[t=" << r.time << "] " << describeTraceRecord(r) << '\n';
+        }
+    }
+    cout << flush;
+    return true;
+}
+
+struct ProcessQueue;
+
+// Process lifecycle states
+enum ProcessState : uint8_t
+{
+    STATE_READY,
+    STATE_RUNNING,
+    STATE_BLOCKED,
+    STATE_SUSPENDED,
+    STATE_COUNT
+};
+
+const char *stateName(ProcessState state)
+{
+    static const char *names[STATE_COUNT] = {"Ready", "Running", "Blocked", "Suspended"};
+    return names[state];
+}
+
+// Ready-queue orderings maintained as heaps alongside the ready list
+enum ReadyHeapKind
+{
+    FCFS_HEAP,     // (AT, pid)
+    PRIORITY_HEAP, // (highest priority, AT, pid)
+    SJF_HEAP,      // (BT, AT, pid)
+    SRTF_HEAP,     // (remainingBT, AT, pid)
+    EDF_HEAP,      // (deadline, AT, pid); processes without one last
+    READY_HEAP_COUNT
+};
+
+struct Process
+{
+    int process_id;
+    int AT;           // Arrival Time
+    int BT;           // Burst Time
+    int remainingBT;  // Remaining Burst Time for Round-Robin
+    int priority;     // Priority
+    int page_size;
+    int memory_allocated;
+    int process_size;
+    ProcessState state;
+    Process *next;
+    Process *prev;        // Intrusive back link within the owning queue
+    ProcessQueue *queue;  // Queue currently holding the process (nullptr if none)
+    int heapIndex[READY_HEAP_COUNT]; // Position in each ready heap (-1 if absent)
+    int mlfqLevel;        // Multilevel Feedback Queue level (0 = top)
+    long long mlfqTicket; // Sequence number of the process's current level queue entry
+    int cpuAffinity;      // CPU the process is pinned to in multi-core simulation (-1 = any)
+    long long stridePass; // Stride scheduling pass
+    int deadline;         // Absolute deadline tick (-1 = none)
+};
+
+// Intrusive doubly-linked queue; insertion and removal are O(1)
+struct ProcessQueue
+{
+    Process *head;
+    Process *tail;
+    int size;
+
+    ProcessQueue() : head(nullptr), tail(nullptr), size(0) {}
+
+    void pushFront(Process *process)
+    {
+        process->prev = nullptr;
+        process->next = head;
+        if (head)
+            head->prev = process;
+        else
+            tail = process;
+        head = process;
+        process->queue = this;
+        size++;
+    }
+
+    void pushBack(Process *process)
+    {
+        process->next = nullptr;
+        process->prev = tail;
+        if (tail)
+            tail->next = process;
+        else
+            head = process;
+        tail = process;
+        process->queue = this;
+        size++;
+    }
+
+    // Move the head to the tail (one Round-Robin rotation)
+    void rotate()
+    {
+        if (head == tail)
+            return;
+        Process *first = head;
+        head = first->next;
+        head->prev = nullptr;
+        first->next = nullptr;
+        first->prev = tail;
+        tail->next = first;
+        tail = first;
+    }
+
+    void remove(Process *process)
+    {
+        if (process->prev)
+            process->prev->next = process->next;
+        else
+            head = process->next;
+        if (process->next)
+            process->next->prev = process->prev;
+        else
+            tail = process->prev;
+        process->next = process->prev = nullptr;
+        process->queue = nullptr;
+        size--;
+    }
+};
+
+// Binary min-heap of processes ordered by Before. Each entry's position is
+// kept in Process::heapIndex[Slot] so it can be removed or re-keyed in O(log n).
+template <int Slot, typename Before>
+class ProcessHeap
+{
+private:
+    vector<Process *> heap;
+    Before before;
+
+    void place(size_t i, Process *process)
+    {
+        heap[i] = process;
+        process->heapIndex[Slot] = (int)i;
+    }
+
+    void siftUp(size_t i)
+    {
+        Process *process = heap[i];
+        while (i > 0)
+        {
+            size_t parent = (i - 1) / 2;
+            if (!before(process, heap[parent]))
+                break;
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, process);
+    }
+
+    void siftDown(size_t i)
+    {
+        Process *process = heap[i];
+        size_t n = heap.size();
+        while (true)
+        {
+            size_t child = 2 * i + 1;
+            if (child >= n)
+                break;
+            if (child + 1 < n && before(heap[child + 1], heap[child]))
+                child++;
+            if (!before(heap[child], process))
+                break;
+            place(i, heap[child]);
+            i = child;
+        }
+        place(i, process);
+    }
+
+public:
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    Process *top() const { return heap.empty() ? nullptr : heap.front(); }
+    void reserve(size_t n) { heap.reserve(n); }
+    // Forget every entry; heapIndex fields of the removed records are left stale
+    void clear() { heap.clear(); }
+
+    // Refill with n entries at known positions (a saved heap); every
+    // position must then be set with restore()
+    void restoreSize(size_t n) { heap.assign(n, nullptr); }
+    void restore(size_t i, Process *process) { place(i, process); }
+
+    void push(Process *process)
+    {
+        heap.push_back(process);
+        siftUp(heap.size() - 1);
+    }
+
+    // Add an entry without restoring heap order; heapify() must follow
+    void append(Process *process)
+    {
+        heap.push_back(process);
+        process->heapIndex[Slot] = (int)heap.size() - 1;
+    }
+
+    // Restore heap order after the last appended entries were append()ed.
+    // A few are sifted up; many are merged by a bottom-up rebuild.
+    void heapify(size_t appended)
+    {
+        size_t n = heap.size();
+        if (appended * 16 < n)
+            for (size_t i = n - appended; i < n; i++)
+                siftUp(i);
+        else
+            for (size_t i = n / 2; i-- > 0;)
+                siftDown(i);
+    }
+
+    void remove(Process *process)
+    {
+        size_t i = process->heapIndex[Slot];
+        Process *last = heap.back();
+        heap.pop_back();
+        process->heapIndex[Slot] = -1;
+        if (last != process)
+        {
+            place(i, last);
+            update(last);
+        }
+    }
+
+    // Restore heap order after the key of an entry has changed
+    void update(Process *process)
+    {
+        size_t i = process->heapIndex[Slot];
+        siftUp(i);
+        siftDown(process->heapIndex[Slot]);
+    }
+};
+
+struct ArrivesFirst
+{
+    bool operator()(const Process *a, const Process *b) const
+    {
+        if (a->AT != b->AT)
+            return a->AT < b->AT;
+        return a->process_id < b->process_id;
+    }
+};
+
+struct HigherPriority
+{
+    bool operator()(const Process *a, const Process *b) const
+    {
+        if (a->priority != b->priority)
+            return a->priority > b->priority;
+        if (a->AT != b->AT)
+            return a->AT < b->AT;
+        return a->process_id < b->process_id;
+    }
+};
+
+struct ShorterJob
+{
+    bool operator()(const Process *a, const Process *b) const
+    {
+        if (a->BT != b->BT)
+            return a->BT < b->BT;
+        if (a->AT != b->AT)
+            return a->AT < b->AT;
+        return a->process_id < b->process_id;
+    }
+};
+
+struct ShorterRemaining
+{
+    bool operator()(const Process *a, const Process *b) const
+    {
+        if (a->remainingBT != b->remainingBT)
+            return a->remainingBT < b->remainingBT;
+        if (a->AT != b->AT)
+            return a->AT < b->AT;
+        return a->process_id < b->process_id;
+    }
+};
+
+struct EarlierDeadline
+{
+    bool operator()(const Process *a, const Process *b) const
+    {
+        // A missing deadline (-1) wraps to the largest key
+        if (a->deadline != b->deadline)
+            return (unsigned)a->deadline < (unsigned)b->deadline;
+        if (a->AT != b->AT)
+            return a->AT < b->AT;
+        return a->process_id < b->process_id;
+    }
+};
+
+// Slab of Process records indexed directly by process_id.
+// Records live in fixed-size chunks so pointers stay valid as the table grows.
+class ProcessTable
+{
+private:
+    static const int CHUNK_SIZE = 4096;
+    vector<unique_ptr<Process[]>> chunks;
+    Process *current;         // Chunk handing out fresh records
+    int usedInChunk;
+    size_t nextChunk;         // Chunks from here on are spare
+    Process *freeList;        // Released records, chained through next
+    vector<Process *> index;  // process_id -> record
+    int count;
+
+public:
+    ProcessTable() : current(nullptr), usedInChunk(CHUNK_SIZE), nextChunk(0), freeList(nullptr), count(0) {}
+
+    // Make room for n more records and PIDs up to maxPid without further allocation
+    void reserve(int n, int maxPid)
+    {
+        long long fresh = (long long)(CHUNK_SIZE - usedInChunk) + (long long)(chunks.size() - nextChunk) * CHUNK_SIZE;
+        for (; fresh < n; fresh += CHUNK_SIZE)
+            chunks.emplace_back(new Process[CHUNK_SIZE]);
+        if (maxPid >= (int)index.size())
+            index.resize((size_t)maxPid + 1, nullptr);
+    }
+
+    // Drop every record at once; chunks are kept for reuse
+    void reset()
+    {
+        current = nullptr;
+        usedInChunk = CHUNK_SIZE;
+        nextChunk = 0;
+        freeList = nullptr;
+        fill(index.begin(), index.end(), nullptr);
+        count = 0;
+    }
+
+    // Get a blank record for pid, reusing a released slot when available
+    Process *allocate(int pid)
+    {
+        Process *process;
+        if (freeList)
+        {
+            process = freeList;
+            freeList = freeList->next;
+        }
+        else
+        {
+            if (usedInChunk == CHUNK_SIZE)
+            {
+                if (nextChunk == chunks.size())
+                    chunks.emplace_back(new Process[CHUNK_SIZE]);
+                current = chunks[nextChunk++].get();
+                usedInChunk = 0;
+            }
+            process = &current[usedInChunk++];
+        }
+        process->process_id = pid;
+        process->next = process->prev = nullptr;
+        process->queue = nullptr;
+        for (int i = 0; i < READY_HEAP_COUNT; i++)
+            process->heapIndex[i] = -1;
+        process->mlfqLevel = 0;
+        process->mlfqTicket = -1;
+        process->cpuAffinity = -1;
+        process->stridePass = 0;
+        process->deadline = -1;
+        if (pid >= (int)index.size())
+            index.resize(max((size_t)pid + 1, index.size() * 2), nullptr);
+        index[pid] = process;
+        count++;
+        return process;
+    }
+
+    // Return a record to the slab; the caller must have unlinked it
+    void release(Process *process)
+    {
+        index[process->process_id] = nullptr;
+        process->next = freeList;
+        freeList = process;
+        count--;
+    }
+
+    Process *lookup(int pid) const
+    {
+        if (pid <= 0 || pid >= (int)index.size())
+            return nullptr;
+        return index[pid];
+    }
+
+    int size() const { return count; }
+};
+
+// Instruction sets the selection kernels can use
+enum SimdLevel
+{
+    SIMD_SCALAR,
+    SIMD_SSE41,
+    SIMD_AVX2,
+    SIMD_LEVEL_COUNT
+};
+
+const char *simdLevelName(SimdLevel level)
+{
+    static const char *names[SIMD_LEVEL_COUNT] = {"scalar", "sse4.1", "avx2"};
+    return names[level];
+}
+
+// Best instruction set supported by the host
+SimdLevel detectSimdLevel()
+{
+#ifdef EAGLE_X86_SIMD
+    if (__builtin_cpu_supports("avx2"))
+        return SIMD_AVX2;
+    if (__builtin_cpu_supports("sse4.1"))
+        return SIMD_SSE41;
+#endif
+    return SIMD_SCALAR;
+}
+
+// Scan kernels over process columns. selectReady returns the index of the
+// entry in STATE_READY that ranks first by key ^ flip (flip = -1 turns it into
+// a largest-key search), then by earlier arrival, then by lower pid, or n if
+// none is ready; the tie-breaks are compared in the same pass as the key.
+// chargeReady gives every ready entry one Round-Robin slice: entries needing
+// more than the quantum are charged it, the rest become Running; it returns
+// the number that became Running.
+static inline bool ranksBefore(const int32_t *key, const int32_t *arrival, const int32_t *pid, int32_t flip, size_t i, size_t j)
+{
+    if (key[i] != key[j])
+        return (key[i] ^ flip) < (key[j] ^ flip);
+    if (arrival[i] != arrival[j])
+        return arrival[i] < arrival[j];
+    return pid[i] < pid[j];
+}
+
+static size_t selectReadyScalar(const int32_t *key, const int32_t *arrival, const int32_t *pid, const uint8_t *state, size_t n, int32_t flip,
+                                size_t from = 0)
+{
+    size_t best = n;
+    for (size_t i = from; i < n; i++)
+        if (state[i] == STATE_READY && (best == n || ranksBefore(key, arrival, pid, flip, i, best)))
+            best = i;
+    return best;
+}
+
+static size_t chargeReadyScalar(int32_t *remaining, uint8_t *state, size_t n, int32_t quantum, size_t from = 0)
+{
+    size_t dispatched = 0;
+    for (size_t i = from; i < n; i++)
+    {
+        if (state[i] != STATE_READY)
+            continue;
+        if (remaining[i] > quantum)
+            remaining[i] -= quantum;
+        else
+        {
+            state[i] = STATE_RUNNING;
+            dispatched++;
+        }
+    }
+    return dispatched;
+}
+
+// Combine per-lane winners and the scalar tail into one answer; entries that
+// rank equal on every column go to the lowest index, as in the scalar scan
+static size_t reduceLanes(const int32_t *laneIndex, int lanes, size_t tail, const int32_t *key, const int32_t *arrival, const int32_t *pid,
+                          const uint8_t *state, size_t n, int32_t flip)
+{
+    size_t best = n;
+    for (int l = 0; l < lanes; l++)
+    {
+        if (laneIndex[l] < 0)
+            continue;
+        size_t i = laneIndex[l];
+        if (best == n || ranksBefore(key, arrival, pid, flip, i, best) || (i < best && !ranksBefore(key, arrival, pid, flip, best, i)))
+            best = i;
+    }
+    size_t rest = selectReadyScalar(key, arrival, pid, state, n, flip, tail);
+    if (rest < n && (best == n || ranksBefore(key, arrival, pid, flip, rest, best)))
+        best = rest;
+    return best;
+}
+
+#ifdef EAGLE_X86_SIMD
+__attribute__((target("sse4.1")))
+static size_t selectReadySse41(const int32_t *key, const int32_t *arrival, const int32_t *pid, const uint8_t *state, size_t n, int32_t flip)
+{
+    const __m128i flipv = _mm_set1_epi32(flip);
+    const __m128i ready = _mm_set1_epi32(STATE_READY);
+    const __m128i unset = _mm_set1_epi32(-1);
+    const __m128i step = _mm_set1_epi32(4);
+    __m128i bestKey = _mm_setzero_si128(), bestArrival = _mm_setzero_si128(), bestPid = _mm_setzero_si128();
+    __m128i bestIndex = unset;
+    __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        int32_t states;
+        memcpy(&states, state + i, sizeof(states));
+        __m128i isReady = _mm_cmpeq_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(states)), ready);
+        __m128i k = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(key + i)), flipv);
+        __m128i a = _mm_loadu_si128((const __m128i *)(arrival + i));
+        __m128i p = _mm_loadu_si128((const __m128i *)(pid + i));
+        // (k, a, p) < (bestKey, bestArrival, bestPid), or the lane has no winner yet
+        __m128i later = _mm_or_si128(_mm_cmpgt_epi32(bestArrival, a), _mm_and_si128(_mm_cmpeq_epi32(bestArrival, a), _mm_cmpgt_epi32(bestPid, p)));
+        __m128i ahead = _mm_or_si128(_mm_cmpgt_epi32(bestKey, k), _mm_and_si128(_mm_cmpeq_epi32(bestKey, k), later));
+        __m128i better = _mm_and_si128(isReady, _mm_or_si128(ahead, _mm_cmpeq_epi32(bestIndex, unset)));
+        bestKey = _mm_blendv_epi8(bestKey, k, better);
+        bestArrival = _mm_blendv_epi8(bestArrival, a, better);
+        bestPid = _mm_blendv_epi8(bestPid, p, better);
+        bestIndex = _mm_blendv_epi8(bestIndex, index, better);
+        index = _mm_add_epi32(index, step);
+    }
+    int32_t laneIndex[4];
+    _mm_storeu_si128((__m128i *)laneIndex, bestIndex);
+    return reduceLanes(laneIndex, 4, i, key, arrival, pid, state, n, flip);
+}
+
+__attribute__((target("sse4.1")))
+static size_t chargeReadySse41(int32_t *remaining, uint8_t *state, size_t n, int32_t quantum)
+{
+    const __m128i q = _mm_set1_epi32(quantum);
+    const __m128i ready = _mm_set1_epi32(STATE_READY);
+    size_t dispatched = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        int32_t states;
+        memcpy(&states, state + i, sizeof(states));
+        __m128i isReady = _mm_cmpeq_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(states)), ready);
+        __m128i r = _mm_loadu_si128((const __m128i *)(remaining + i));
+        __m128i longer = _mm_cmpgt_epi32(r, q);
+        __m128i charge = _mm_and_si128(isReady, longer);
+        _mm_storeu_si128((__m128i *)(remaining + i), _mm_sub_epi32(r, _mm_and_si128(charge, q)));
+        int finish = _mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(longer, isReady)));
+        for (; finish; finish &= finish - 1, dispatched++)
+            state[i + __builtin_ctz(finish)] = STATE_RUNNING;
+    }
+    return dispatched + chargeReadyScalar(remaining, state, n, quantum, i);
+}
+
+__attribute__((target("avx2")))
+static size_t selectReadyAvx2(const int32_t *key, const int32_t *arrival, const int32_t *pid, const uint8_t *state, size_t n, int32_t flip)
+{
+    const __m256i flipv = _mm256_set1_epi32(flip);
+    const __m256i ready = _mm256_set1_epi32(STATE_READY);
+    const __m256i unset = _mm256_set1_epi32(-1);
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i bestKey = _mm256_setzero_si256(), bestArrival = _mm256_setzero_si256(), bestPid = _mm256_setzero_si256();
+    __m256i bestIndex = unset;
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i isReady = _mm256_cmpeq_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(state + i))), ready);
+        __m256i k = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(key + i)), flipv);
+        __m256i a = _mm256_loadu_si256((const __m256i *)(arrival + i));
+        __m256i p = _mm256_loadu_si256((const __m256i *)(pid + i));
+        __m256i later = _mm256_or_si256(_mm256_cmpgt_epi32(bestArrival, a), _mm256_and_si256(_mm256_cmpeq_epi32(bestArrival, a), _mm256_cmpgt_epi32(bestPid, p)));
+        __m256i ahead = _mm256_or_si256(_mm256_cmpgt_epi32(bestKey, k), _mm256_and_si256(_mm256_cmpeq_epi32(bestKey, k), later));
+        __m256i better = _mm256_and_si256(isReady, _mm256_or_si256(ahead, _mm256_cmpeq_epi32(bestIndex, unset)));
+        bestKey = _mm256_blendv_epi8(bestKey, k, better);
+        bestArrival = _mm256_blendv_epi8(bestArrival, a, better);
+        bestPid = _mm256_blendv_epi8(bestPid, p, better);
+        bestIndex = _mm256_blendv_epi8(bestIndex, index, better);
+        index = _mm256_add_epi32(index, step);
+    }
+    int32_t laneIndex[8];
+    _mm256_storeu_si256((__m256i *)laneIndex, bestIndex);
+    return reduceLanes(laneIndex, 8, i, key, arrival, pid, state, n, flip);
+}
+
+__attribute__((target("avx2")))
+static size_t chargeReadyAvx2(int32_t *remaining, uint8_t *state, size_t n, int32_t quantum)
+{
+    const __m256i q = _mm256_set1_epi32(quantum);
+    const __m256i ready = _mm256_set1_epi32(STATE_READY);
+    size_t dispatched = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i isReady = _mm256_cmpeq_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(state + i))), ready);
+        __m256i r = _mm256_loadu_si256((const __m256i *)(remaining + i));
+        __m256i longer = _mm256_cmpgt_epi32(r, q);
+        __m256i charge = _mm256_and_si256(isReady, longer);
+        _mm256_storeu_si256((__m256i *)(remaining + i), _mm256_sub_epi32(r, _mm256_and_si256(charge, q)));
+        int finish = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_andnot_si256(longer, isReady)));
+        for (; finish; finish &= finish - 1, dispatched++)
+            state[i + __builtin_ctz(finish)] = STATE_RUNNING;
+    }
+    return dispatched + chargeReadyScalar(remaining, state, n, quantum, i);
+}
+#endif
+
+size_t selectReady(const int32_t *key, const int32_t *arrival, const int32_t *pid, const uint8_t *state, size_t n, int32_t flip, SimdLevel level)
+{
+#ifdef EAGLE_X86_SIMD
+    if (level == SIMD_AVX2)
+        return selectReadyAvx2(key, arrival, pid, state, n, flip);
+    if (level == SIMD_SSE41)
+        return selectReadySse41(key, arrival, pid, state, n, flip);
+#endif
+    (void)level;
+    return selectReadyScalar(key, arrival, pid, state, n, flip);
+}
+
+size_t chargeReady(int32_t *remaining, uint8_t *state, size_t n, int32_t quantum, SimdLevel level)
+{
+#ifdef EAGLE_X86_SIMD
+    if (level == SIMD_AVX2)
+        return chargeReadyAvx2(remaining, state, n, quantum);
+    if (level == SIMD_SSE41)
+        return chargeReadySse41(remaining, state, n, quantum);
+#endif
+    (void)level;
+    return chargeReadyScalar(remaining, state, n, quantum);
+}
+
+// Struct-of-arrays process store: one contiguous column per field, so a
+// scheduling pick streams only the key and state columns. Rows are addressed
+// by slot; ties in a pick resolve like the list schedulers' comparators:
+// earlier arrival, then lower PID.
+class ProcessColumns
+{
+public:
+    vector<int32_t> pid;
+    vector<int32_t> arrival;
+    vector<int32_t> burst;
+    vector<int32_t> remaining;
+    vector<int32_t> priority;
+    vector<uint8_t> state;
+
+    size_t size() const { return pid.size(); }
+
+    void reserve(size_t n)
+    {
+        pid.reserve(n);
+        arrival.reserve(n);
+        burst.reserve(n);
+        remaining.reserve(n);
+        priority.reserve(n);
+        state.reserve(n);
+    }
+
+    void add(int processId, int AT, int BT, int remainingBT, int prio, ProcessState processState = STATE_READY)
+    {
+        pid.push_back(processId);
+        arrival.push_back(AT);
+        burst.push_back(BT);
+        remaining.push_back(remainingBT);
+        priority.push_back(prio);
+        state.push_back(processState);
+    }
+
+    // Ready slot to run next under each policy (size() if none is ready)
+    size_t pickFirstArrival(SimdLevel level) const { return pick(arrival, 0, level); }
+    size_t pickShortest(SimdLevel level) const { return pick(burst, 0, level); }
+    size_t pickHighestPriority(SimdLevel level) const { return pick(priority, -1, level); }
+
+    // One Round-Robin pass over every ready slot; returns the number dispatched
+    size_t roundRobinPass(int quantum, SimdLevel level) { return chargeReady(remaining.data(), state.data(), size(), quantum, level); }
+
+private:
+    size_t pick(const vector<int32_t> &key, int32_t flip, SimdLevel level) const
+    {
+        return selectReady(key.data(), arrival.data(), pid.data(), state.data(), size(), flip, level);
+    }
+};
+
+// Scheduling policies understood by the discrete-event simulator
+enum SchedulingPolicy
+{
+    POLICY_FCFS,
+    POLICY_PRIORITY,
+    POLICY_SJF,
+    POLICY_RR,
+    POLICY_MLQ,
+    POLICY_MLFQ,
+    POLICY_LOTTERY,
+    POLICY_STRIDE,
+    POLICY_SRTF,
+    POLICY_EDF,
+    POLICY_COUNT
+};
+
+const char *policyName(SchedulingPolicy policy)
+{
+    static const char *names[POLICY_COUNT] = {"FCFS", "Priority", "SJF", "Round-Robin", "Multilevel Queue", "Multilevel Feedback Queue", "Lottery", "Stride", "SRTF", "EDF"};
+    return names[policy];
+}
+
+// Short lowercase policy names used on command lines and in stats keys
+const char *policyKey(SchedulingPolicy policy)
+{
+    static const char *names[POLICY_COUNT] = {"fcfs", "priority", "sjf", "rr", "mlq", "mlfq", "lottery", "stride", "srtf", "edf"};
+    return names[policy];
+}
+
+// Lottery tickets or stride shares held by a process of the given priority
+inline long long ticketsFor(int priority)
+{
+    return max(1LL, (long long)priority + 1);
+}
+
+// Stride scheduling pass charged for one full quantum; fewer tickets, longer stride
+const long long STRIDE1 = 1 << 20;
+
+inline long long strideFor(int priority)
+{
+    return STRIDE1 / ticketsFor(priority);
+}
+
+// Hot-path instrumentation. Each thread counts into its own slab, so an
+// update is an uncontended load and store on memory no other thread writes;
+// a snapshot sums the slabs. Build with -DEAGLE_INSTRUMENT=0 to compile the
+// counters, timers and queue gauges out entirely.
+#ifndef EAGLE_INSTRUMENT
+#define EAGLE_INSTRUMENT 1
+#endif
+
+enum CounterId
+{
+    COUNTER_TRANSITION = 0,                                                 // + from * STATE_COUNT + to
+    COUNTER_DISPATCH = COUNTER_TRANSITION + STATE_COUNT * STATE_COUNT,      // + policy, live scheduler
+    COUNTER_SIM_DISPATCH = COUNTER_DISPATCH + POLICY_COUNT,                 // + policy, simulator runs
+    COUNTER_PAGE_HIT = COUNTER_SIM_DISPATCH + POLICY_COUNT,
+    COUNTER_PAGE_FAULT,
+    COUNTER_MESSAGE_SENT,
+    COUNTER_MESSAGE_RECEIVED,
+    COUNTER_RECEIVE_BLOCK, // Receives that found an empty mailbox and blocked
+    COUNTER_PREEMPTION,    // Running processes displaced by a better ready arrival
+    COUNTER_COUNT
+};
+
+enum TimerId
+{
+    TIMER_SCHEDULING,  // Live scheduling calls
+    TIMER_SIMULATION,  // Single-core and multi-core simulator runs
+    TIMER_REPLACEMENT, // Page replacement runs
+    TIMER_MEMORY,      // Virtual memory workloads
+    TIMER_COUNT
+};
+
+const char *timerName(TimerId timer)
+{
+    static const char *names[TIMER_COUNT] = {"scheduling", "simulation", "replacement", "memory"};
+    return names[timer];
+}
+
+inline int transitionCounter(ProcessState from, ProcessState to)
+{
+    return COUNTER_TRANSITION + from * STATE_COUNT + to;
+}
+
+// Counter totals; timers hold accumulated nanoseconds and call counts
+struct CounterSnapshot
+{
+    uint64_t counters[COUNTER_COUNT];
+    uint64_t timerNanos[TIMER_COUNT];
+    uint64_t timerCalls[TIMER_COUNT];
+
+    CounterSnapshot()
+    {
+        memset(counters, 0, sizeof(counters));
+        memset(timerNanos, 0, sizeof(timerNanos));
+        memset(timerCalls, 0, sizeof(timerCalls));
+    }
+};
+
+#if EAGLE_INSTRUMENT
+class Instrumentation
+{
+private:
+    static const int SLOTS = COUNTER_COUNT + 2 * TIMER_COUNT;
+
+    // One thread's counters. The padding on both sides keeps neighbouring
+    // slabs off its cache lines whatever alignment the allocator gives.
+    struct CounterSlab
+    {
+        char leading[64];
+        atomic<uint64_t> values[SLOTS];
+        char trailing[64];
+    };
+
+    // Returns a thread's slab to the registry when the thread exits
+    struct SlabHandle
+    {
+        CounterSlab *slab;
+        SlabHandle() : slab(nullptr) {}
+        ~SlabHandle()
+        {
+            if (slab)
+                registry().retire(slab);
+        }
+    };
+
+    mutex lock;
+    vector<unique_ptr<CounterSlab>> slabs; // Every slab ever handed out
+    vector<CounterSlab *> spare;           // Slabs of exited threads, zeroed
+    uint64_t retired[SLOTS];               // Counts folded in from exited threads
+    uint64_t baseline[SLOTS];              // Totals at the last reset
+
+    Instrumentation()
+    {
+        memset(retired, 0, sizeof(retired));
+        memset(baseline, 0, sizeof(baseline));
+    }
+
+    static Instrumentation &registry()
+    {
+        static Instrumentation instance;
+        return instance;
+    }
+
+    CounterSlab *acquire()
+    {
+        lock_guard<mutex> guard(lock);
+        if (!spare.empty())
+        {
+            CounterSlab *slab = spare.back();
+            spare.pop_back();
+            return slab;
+        }
+        slabs.emplace_back(new CounterSlab());
+        for (int i = 0; i < SLOTS; i++)
+            slabs.back()->values[i].store(0, memory_order_relaxed);
+        return slabs.back().get();
+    }
+
+    void retire(CounterSlab *slab)
+    {
+        lock_guard<mutex> guard(lock);
+        for (int i = 0; i < SLOTS; i++)
+        {
+            retired[i] += slab->values[i].load(memory_order_relaxed);
+            slab->values[i].store(0, memory_order_relaxed);
+        }
+        spare.push_back(slab);
+    }
+
+    void totals(uint64_t *sum)
+    {
+        memcpy(sum, retired, sizeof(retired));
+        for (const unique_ptr<CounterSlab> &slab : slabs)
+            for (int i = 0; i < SLOTS; i++)
+                sum[i] += slab->values[i].load(memory_order_relaxed);
+    }
+
+    static void bump(int slot, uint64_t amount)
+    {
+        static thread_local SlabHandle handle;
+        if (!handle.slab)
+            handle.slab = registry().acquire();
+        atomic<uint64_t> &value = handle.slab->values[slot];
+        value.store(value.load(memory_order_relaxed) + amount, memory_order_relaxed);
+    }
+
+public:
+    static void add(int counter, uint64_t amount = 1) { bump(counter, amount); }
+
+    static void addTime(TimerId timer, uint64_t nanos)
+    {
+        bump(COUNTER_COUNT + timer, nanos);
+        bump(COUNTER_COUNT + TIMER_COUNT + timer, 1);
+    }
+
+    // Totals since the last reset (slabs of running threads are read without stopping them)
+    static CounterSnapshot snapshot()
+    {
+        Instrumentation &self = registry();
+        uint64_t sum[SLOTS];
+        {
+            lock_guard<mutex> guard(self.lock);
+            self.totals(sum);
+            for (int i = 0; i < SLOTS; i++)
+                sum[i] -= self.baseline[i];
+        }
+        CounterSnapshot snapshot;
+        memcpy(snapshot.counters, sum, sizeof(snapshot.counters));
+        memcpy(snapshot.timerNanos, sum + COUNTER_COUNT, sizeof(snapshot.timerNanos));
+        memcpy(snapshot.timerCalls, sum + COUNTER_COUNT + TIMER_COUNT, sizeof(snapshot.timerCalls));
+        return snapshot;
+    }
+
+    // Start counting from zero; slabs are owned by their threads, so the
+    // current totals become the baseline instead of being cleared
+    static void reset()
+    {
+        Instrumentation &self = registry();
+        lock_guard<mutex> guard(self.lock);
+        self.totals(self.baseline);
+    }
+};
+
+// Adds the lifetime of the scope to a timer
+class ScopedTimer
+{
+private:
+    TimerId timer;
+    chrono::steady_clock::time_point started;
+
+public:
+    explicit ScopedTimer(TimerId t) : timer(t), started(chrono::steady_clock::now()) {}
+    ~ScopedTimer()
+    {
+        Instrumentation::addTime(timer, (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - started).count());
+    }
+};
+#else
+struct Instrumentation
+{
+    static void add(int, uint64_t = 1) {}
+    static void addTime(TimerId, uint64_t) {}
+    static CounterSnapshot snapshot() { return CounterSnapshot(); }
+    static void reset() {}
+};
+
+struct ScopedTimer
+{
+    explicit ScopedTimer(TimerId) {}
+};
+#endif
+
+// xoshiro256** generator (Blackman and Vigna), seeded through splitmix64.
+// It is much faster than mt19937 and has only 32 bytes of state. Its output
+// depends only on the seed, so the same seed gives the same workload on any
+// standard library.
+class Xoshiro256
+{
+private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+public:
+    typedef uint64_t result_type;
+
+    explicit Xoshiro256(uint64_t seed = 1) { this->seed(seed); }
+
+    void seed(uint64_t seed)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            s[i] = z ^ (z >> 31);
+        }
+    }
+
+    // Raw state, for saving and resuming the stream exactly
+    const uint64_t *state() const { return s; }
+    void restore(const uint64_t *state) { memcpy(s, state, sizeof(s)); }
+
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return ~0ULL; }
+
+    uint64_t operator()()
+    {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Uniform in [0, 1)
+    double uniform() { return ((*this)() >> 11) * (1.0 / 9007199254740992.0); }
+
+    // Uniform in [0, n) by multiply-shift (n < 2^32)
+    uint32_t below(uint32_t n) { return (uint32_t)((((*this)() >> 32) * n) >> 32); }
+
+    double exponential(double mean) { return -mean * log(1.0 - uniform()); }
+
+    // Standard normal by Box-Muller (one value per call keeps the stream simple)
+    double normal()
+    {
+        double u = 1.0 - uniform();
+        return sqrt(-2.0 * log(u)) * cos(6.283185307179586 * uniform());
+    }
+};
+
+// Fenwick (binary indexed) tree over non-negative weights. Updates are
+// O(log n), and find() descends the implicit tree to the slot holding a given
+// cumulative weight, so a weighted random pick is O(log n) as well.
+class FenwickTree
+{
+private:
+    vector<long long> tree; // 1-based partial sums
+    size_t topBit;          // Highest power of two not above the size
+    long long sum;
+
+public:
+    FenwickTree() : topBit(0), sum(0) {}
+
+    // Build over weights in O(n)
+    void assign(const vector<long long> &weights)
+    {
+        size_t n = weights.size();
+        tree.assign(n + 1, 0);
+        sum = 0;
+        for (size_t i = 1; i <= n; i++)
+        {
+            tree[i] += weights[i - 1];
+            sum += weights[i - 1];
+            size_t parent = i + (i & (~i + 1));
+            if (parent <= n)
+                tree[parent] += tree[i];
+        }
+        for (topBit = n ? 1 : 0; topBit && topBit * 2 <= n; topBit *= 2)
+            ;
+    }
+
+    void add(size_t slot, long long delta)
+    {
+        sum += delta;
+        for (size_t i = slot + 1; i < tree.size(); i += i & (~i + 1))
+            tree[i] += delta;
+    }
+
+    long long total() const { return sum; }
+
+    // Slot covering cumulative weight target, for 0 <= target < total()
+    size_t find(long long target) const
+    {
+        size_t slot = 0;
+        for (size_t step = topBit; step > 0; step >>= 1)
+            if (slot + step < tree.size() && tree[slot + step] <= target)
+            {
+                slot += step;
+                target -= tree[slot];
+            }
+        return slot;
+    }
+};
+
+// Service received by one tenant over a proportional-share run
+struct TenantShare
+{
+    int priority;
+    long long tickets;  // Tickets held per runnable process
+    int processes;
+    long long received; // Ticks of CPU service
+    double entitled;    // Ticks owed for the tickets held while runnable
+    double maxLag;      // Largest |entitled - received| seen
+};
+
+// Fairness accounting for a scheduling run. A tenant is every process with
+// one priority, holding ticketsFor(priority) tickets per runnable process.
+// Virtual time advances by busy ticks over the runnable tickets, so a tenant
+// is entitled to its tickets times the virtual time it spent runnable, and
+// its lag is what it was owed less what it received. A tenant's lag only
+// peaks when it is picked or when its slice ends, so checking it there keeps
+// every update O(1).
+class ShareLedger
+{
+private:
+    vector<TenantShare> tenants; // Ordered by priority
+    vector<int> tenantOf;        // Item -> tenant
+    vector<long long> active;    // Runnable tickets per tenant
+    vector<double> settledAt;    // Virtual time each entitlement is settled to
+    long long totalTickets;
+    double virtualTime;
+
+    void settle(int tenant)
+    {
+        tenants[tenant].entitled += active[tenant] * (virtualTime - settledAt[tenant]);
+        settledAt[tenant] = virtualTime;
+    }
+
+public:
+    // One item per process, identified by its index in priorities
+    explicit ShareLedger(const vector<int> &priorities) : tenantOf(priorities.size()), totalTickets(0), virtualTime(0)
+    {
+        unordered_map<int, int> index;
+        for (int priority : priorities)
+            if (index.insert(make_pair(priority, 0)).second)
+                tenants.push_back(TenantShare{priority, ticketsFor(priority), 0, 0, 0.0, 0.0});
+        sort(tenants.begin(), tenants.end(), [](const TenantShare &a, const TenantShare &b) { return a.priority < b.priority; });
+        for (size_t t = 0; t < tenants.size(); t++)
+            index[tenants[t].priority] = (int)t;
+        for (size_t i = 0; i < priorities.size(); i++)
+        {
+            tenantOf[i] = index[priorities[i]];
+            tenants[tenantOf[i]].processes++;
+        }
+        active.assign(tenants.size(), 0);
+        settledAt.assign(tenants.size(), 0.0);
+    }
+
+    // The item became runnable
+    void join(int item)
+    {
+        int tenant = tenantOf[item];
+        settle(tenant);
+        active[tenant] += tenants[tenant].tickets;
+        totalTickets += tenants[tenant].tickets;
+    }
+
+    // The item stopped being runnable
+    void leave(int item)
+    {
+        int tenant = tenantOf[item];
+        settle(tenant);
+        active[tenant] -= tenants[tenant].tickets;
+        totalTickets -= tenants[tenant].tickets;
+    }
+
+    // Busy ticks, shared out over everything runnable
+    void advance(long long ticks)
+    {
+        if (totalTickets > 0)
+            virtualTime += (double)ticks / totalTickets;
+    }
+
+    void charge(int item, long long ticks) { tenants[tenantOf[item]].received += ticks; }
+
+    // Record the lag of the item's tenant at this instant
+    void check(int item)
+    {
+        int tenant = tenantOf[item];
+        settle(tenant);
+        TenantShare &share = tenants[tenant];
+        share.maxLag = max(share.maxLag, fabs(share.entitled - share.received));
+    }
+
+    // Per-tenant shares, settled to the current virtual time
+    vector<TenantShare> shares()
+    {
+        for (size_t t = 0; t < tenants.size(); t++)
+            settle((int)t);
+        return tenants;
+    }
+
+    // Worst lag of any tenant, in ticks
+    double fairnessError() const
+    {
+        double worst = 0;
+        for (const TenantShare &share : tenants)
+            worst = max(worst, share.maxLag);
+        return worst;
+    }
+};
+
+// A process as seen by the simulator; times are in simulated ticks
+struct SimJob
+{
+    int pid;
+    int AT;
+    int burst;          // CPU demand at the start of the run
+    int remainingBT;
+    int priority;
+    long long firstRun;   // -1 until first dispatched
+    long long completion; // -1 until finished
+    int cpu;              // CPU the job is pinned to in multi-core runs (-1 = any)
+    int deadline;         // Absolute deadline tick (-1 = none)
+
+    long long turnaround() const { return completion - AT; }
+    long long waiting() const { return turnaround() - burst; }
+    long long response() const { return firstRun - AT; }
+};
+
+struct SimulationOptions
+{
+    SchedulingPolicy policy;
+    int timeQuantum;  // Round-Robin slice, also used by the low Multilevel Queue level and the proportional-share policies
+    bool adaptiveQuantum; // Derive the Round-Robin slice from the queued bursts each round
+    int mlqThreshold; // Priority at or above which a job is in the high Multilevel Queue level
+    int mlfqLevels;   // Multilevel Feedback Queue levels; level i runs slices of timeQuantum << i
+    int boostInterval; // Ticks between Multilevel Feedback Queue boosts to the top level (0 = never)
+    uint64_t seed;      // Lottery draw seed
+    TraceWriter *trace; // Optional binary trace of dispatches and completions
+
+    SimulationOptions(SchedulingPolicy p = POLICY_FCFS)
+        : policy(p), timeQuantum(10), adaptiveQuantum(false), mlqThreshold(5), mlfqLevels(3), boostInterval(1000), seed(1), trace(nullptr) {}
+
+    // Set the Round-Robin quantum; 0 selects the adaptive quantum
+    void setQuantum(int quantum)
+    {
+        adaptiveQuantum = quantum == 0;
+        if (quantum > 0)
+            timeQuantum = quantum;
+    }
+};
+
+struct SimulationResult
+{
+    SchedulingPolicy policy;
+    vector<SimJob> jobs;
+    long long makespan;        // Time the last job completed
+    long long busyTime;        // Ticks the CPU spent running jobs
+    long long contextSwitches; // Dispatches that changed the running job
+    long long dispatches;      // Slices handed out
+    long long preemptions;     // Running jobs displaced by a better arrival
+    long long events;          // Events processed by the engine
+    double avgTurnaround;
+    double avgWaiting;
+    double avgResponse;
+    long long maxWaiting;
+    long long p95Turnaround;   // Tail latencies
+    long long p99Turnaround;
+    long long p95Response;
+    long long p99Response;
+    vector<TenantShare> tenants; // Service per priority against its ticket share
+    double fairnessError;      // Worst tenant lag, in ticks
+    long long deadlineJobs;    // Jobs that have a deadline
+    long long deadlineMisses;  // ... and completed after it
+    double avgLateness;        // Lateness = completion - deadline, negative when early
+    long long p95Lateness;
+    long long p99Lateness;
+    long long maxLateness;
+    double elapsedSeconds;     // Wall-clock time of the run
+
+    double missRate() const { return deadlineJobs > 0 ? (double)deadlineMisses / deadlineJobs : 0.0; }
+    double throughput() const { return makespan > 0 ? (double)jobs.size() / makespan : 0.0; }
+    double utilization() const { return makespan > 0 ? (double)busyTime / makespan : 0.0; }
+    double eventsPerSecond() const { return elapsedSeconds > 0 ? events / elapsedSeconds : 0.0; }
+    double averageSlice() const { return dispatches > 0 ? (double)busyTime / dispatches : 0.0; }
+};
+
+// Round-Robin quantum as shown to the user; 0 is the adaptive quantum
+string quantumName(int quantum)
+{
+    return quantum == 0 ? "adaptive" : to_string(quantum);
+}
+
+// Ready set used by the simulator; each policy supplies its own ordering
+class SimReadyQueue
+{
+public:
+    virtual ~SimReadyQueue() {}
+    virtual void push(int job) = 0;
+    virtual int pop() = 0;
+    virtual bool empty() const = 0;
+    // Longest slice the job may run before it is requeued (0 = run to completion)
+    virtual int quantum(int job) const = 0;
+    // Called with the current time before each dispatch
+    virtual void advance(long long) {}
+    // Whether arrivals may preempt the running job; the engine then charges
+    // the running job up to each arrival before asking preempts()
+    virtual bool preemptive() const { return false; }
+    virtual bool preempts(int, int) const { return false; }
+};
+
+// Non-preemptive ready set ordered by Before over job indices
+template <typename Before>
+class HeapReadyQueue : public SimReadyQueue
+{
+private:
+    // std heap algorithms build a max-heap, so invert the ordering
+    struct After
+    {
+        Before before;
+        bool operator()(int a, int b) const { return before(b, a); }
+    };
+
+    vector<int> heap;
+    After after;
+
+public:
+    explicit HeapReadyQueue(const Before &before) : after{before} {}
+
+    void push(int job)
+    {
+        heap.push_back(job);
+        push_heap(heap.begin(), heap.end(), after);
+    }
+
+    int pop()
+    {
+        pop_heap(heap.begin(), heap.end(), after);
+        int job = heap.back();
+        heap.pop_back();
+        return job;
+    }
+
+    bool empty() const { return heap.empty(); }
+    int quantum(int) const { return 0; }
+};
+
+struct JobArrivesFirst
+{
+    const vector<SimJob> *jobs;
+    bool operator()(int a, int b) const
+    {
+        const SimJob &x = (*jobs)[a], &y = (*jobs)[b];
+        if (x.AT != y.AT)
+            return x.AT < y.AT;
+        return x.pid < y.pid;
+    }
+};
+
+struct JobHigherPriority
+{
+    const vector<SimJob> *jobs;
+    bool operator()(int a, int b) const
+    {
+        const SimJob &x = (*jobs)[a], &y = (*jobs)[b];
+        if (x.priority != y.priority)
+            return x.priority > y.priority;
+        if (x.AT != y.AT)
+            return x.AT < y.AT;
+        return x.pid < y.pid;
+    }
+};
+
+struct JobShorter
+{
+    const vector<SimJob> *jobs;
+    bool operator()(int a, int b) const
+    {
+        const SimJob &x = (*jobs)[a], &y = (*jobs)[b];
+        if (x.burst != y.burst)
+            return x.burst < y.burst;
+        if (x.AT != y.AT)
+            return x.AT < y.AT;
+        return x.pid < y.pid;
+    }
+};
+
+struct JobShorterRemaining
+{
+    const vector<SimJob> *jobs;
+    bool operator()(int a, int b) const
+    {
+        const SimJob &x = (*jobs)[a], &y = (*jobs)[b];
+        if (x.remainingBT != y.remainingBT)
+            return x.remainingBT < y.remainingBT;
+        if (x.AT != y.AT)
+            return x.AT < y.AT;
+        return x.pid < y.pid;
+    }
+};
+
+struct JobEarlierDeadline
+{
+    const vector<SimJob> *jobs;
+    bool operator()(int a, int b) const
+    {
+        const SimJob &x = (*jobs)[a], &y = (*jobs)[b];
+        // A missing deadline (-1) wraps to the largest key
+        if (x.deadline != y.deadline)
+            return (unsigned)x.deadline < (unsigned)y.deadline;
+        if (x.AT != y.AT)
+            return x.AT < y.AT;
+        return x.pid < y.pid;
+    }
+};
+
+// Preemptive ready set ordered by Before: a job runs until it completes or
+// an arrival that Before ranks ahead of it takes the CPU. Keys are read when
+// a job is queued, so a job's remaining time may serve as its key.
+template <typename Before>
+class PreemptiveReadyQueue : public HeapReadyQueue<Before>
+{
+private:
+    Before before;
+
+public:
+    explicit PreemptiveReadyQueue(const Before &b) : HeapReadyQueue<Before>(b), before(b) {}
+
+    bool preemptive() const { return true; }
+    bool preempts(int job, int running) const { return before(job, running); }
+};
+
+// Circular FIFO over a power-of-two ring; push, pop and the
+// Round-Robin rotation (pop then push) are O(1) and the ring only grows
+template <typename T>
+class CircularRunQueue
+{
+private:
+    vector<T> ring;
+    size_t head;
+    size_t count;
+
+public:
+    CircularRunQueue() : ring(64), head(0), count(0) {}
+
+    void push(const T &job)
+    {
+        if (count == ring.size())
+        {
+            vector<T> grown(ring.size() * 2);
+            for (size_t i = 0; i < count; i++)
+                grown[i] = ring[(head + i) & (ring.size() - 1)];
+            ring.swap(grown);
+            head = 0;
+        }
+        ring[(head + count++) & (ring.size() - 1)] = job;
+    }
+
+    // Call visit(job) for each queued job, front first
+    template <typename Visit>
+    void forEach(Visit visit) const
+    {
+        for (size_t i = 0; i < count; i++)
+            visit(ring[(head + i) & (ring.size() - 1)]);
+    }
+
+    T pop()
+    {
+        T job = ring[head];
+        head = (head + 1) & (ring.size() - 1);
+        count--;
+        return job;
+    }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+};
+
+// Round-Robin over a circular run queue. With an adaptive quantum the slice is
+// recomputed at the start of every round (one pass over the jobs queued at that
+// moment) as the mean remaining burst of the queue, so short jobs finish in one
+// slice while long ones are not switched out needlessly.
+class RoundRobinReadyQueue : public SimReadyQueue
+{
+private:
+    const vector<SimJob> &jobs;
+    CircularRunQueue<int> fifo;
+    int slice;
+    bool adaptive;
+    long long queuedBurst; // Sum of remaining bursts in the queue
+    size_t roundLeft;      // Pops left before the next adaptive round starts
+
+public:
+    RoundRobinReadyQueue(const vector<SimJob> &j, int timeQuantum, bool adaptiveQuantum)
+        : jobs(j), slice(timeQuantum), adaptive(adaptiveQuantum), queuedBurst(0), roundLeft(0) {}
+
+    void push(int job)
+    {
+        fifo.push(job);
+        queuedBurst += jobs[job].remainingBT;
+    }
+
+    int pop()
+    {
+        if (adaptive && roundLeft == 0)
+        {
+            roundLeft = fifo.size();
+            slice = (int)max(1LL, (queuedBurst + (long long)roundLeft - 1) / (long long)roundLeft);
+        }
+        if (roundLeft > 0)
+            roundLeft--;
+        int job = fifo.pop();
+        queuedBurst -= jobs[job].remainingBT;
+        return job;
+    }
+
+    bool empty() const { return fifo.empty(); }
+    int quantum(int) const { return slice; }
+};
+
+// Two fixed levels: Priority Scheduling above the threshold, Round-Robin below.
+// The high level is always served first.
+class MultilevelReadyQueue : public SimReadyQueue
+{
+private:
+    const vector<SimJob> &jobs;
+    int threshold;
+    HeapReadyQueue<JobHigherPriority> high;
+    RoundRobinReadyQueue low;
+
+public:
+    MultilevelReadyQueue(const vector<SimJob> &j, int mlqThreshold, int timeQuantum, bool adaptiveQuantum)
+        : jobs(j), threshold(mlqThreshold), high(JobHigherPriority{&j}), low(j, timeQuantum, adaptiveQuantum) {}
+
+    void push(int job)
+    {
+        if (jobs[job].priority >= threshold)
+            high.push(job);
+        else
+            low.push(job);
+    }
+    int pop() { return high.empty() ? low.pop() : high.pop(); }
+    bool empty() const { return high.empty() && low.empty(); }
+    int quantum(int job) const { return jobs[job].priority >= threshold ? 0 : low.quantum(job); }
+};
+
+// Multilevel Feedback Queue: arrivals enter the top level, the highest
+// non-empty level is always served, and a job requeued after using its whole
+// slice drops one level (each level doubles the quantum). Every boostInterval
+// ticks all jobs return to the top level so long jobs cannot starve. A boost
+// moves whole level queues (not jobs) behind the boosted ones, and a job's level
+// only counts if it was set in the current boost epoch, so a boost is O(levels).
+class FeedbackReadyQueue : public SimReadyQueue
+{
+private:
+    vector<CircularRunQueue<int>> levels;
+    deque<CircularRunQueue<int>> boosted; // Queues lifted to the top by boosts, served before levels[0]
+    vector<int> levelOf;
+    vector<int> boostOf;    // Boost epoch in which the job's level was last set
+    vector<char> started;   // Job has been dispatched at least once
+    int baseQuantum;
+    long long boostInterval;
+    long long nextBoost;
+    int epoch;
+    size_t queued;
+
+    int currentLevel(int job) const { return boostOf[job] == epoch ? levelOf[job] : 0; }
+
+public:
+    FeedbackReadyQueue(const vector<SimJob> &jobs, int levelCount, int timeQuantum, int boostTicks)
+        : levels(max(1, levelCount)), levelOf(jobs.size(), 0), boostOf(jobs.size(), 0), started(jobs.size(), 0),
+          baseQuantum(max(1, timeQuantum)), boostInterval(max(0, boostTicks)), nextBoost(boostTicks), epoch(0), queued(0) {}
+
+    void push(int job)
+    {
+        // A job back from the CPU used its full slice: demote it. Boosts only
+        // happen at dispatch, so none can have happened while it ran.
+        levelOf[job] = started[job] ? min(levelOf[job] + 1, (int)levels.size() - 1) : 0;
+        boostOf[job] = epoch;
+        levels[levelOf[job]].push(job);
+        queued++;
+    }
+
+    int pop()
+    {
+        queued--;
+        while (!boosted.empty() && boosted.front().empty())
+            boosted.pop_front();
+        int job;
+        if (!boosted.empty())
+            job = boosted.front().pop();
+        else
+        {
+            size_t level = 0;
+            while (levels[level].empty())
+                level++;
+            job = levels[level].pop();
+        }
+        // Settle a boost the job slept through, so a full slice demotes it
+        levelOf[job] = currentLevel(job);
+        boostOf[job] = epoch;
+        started[job] = 1;
+        return job;
+    }
+
+    bool empty() const { return queued == 0; }
+
+    int quantum(int job) const
+    {
+        return (int)min((long long)baseQuantum << currentLevel(job), (long long)INT_MAX);
+    }
+
+    void advance(long long now)
+    {
+        if (boostInterval == 0 || now < nextBoost)
+            return;
+        epoch++;
+        for (size_t level = 0; level < levels.size(); level++)
+            if (!levels[level].empty())
+            {
+                boosted.push_back(CircularRunQueue<int>());
+                swap(boosted.back(), levels[level]);
+            }
+        nextBoost = (now / boostInterval + 1) * boostInterval;
+    }
+};
+
+// Lottery scheduling: each queued job holds ticketsFor(priority) tickets in a
+// Fenwick tree indexed by job, and every pick draws one ticket uniformly, so
+// a job's chance of the CPU is its share of the queued tickets. Picks and
+// requeues are O(log n).
+class LotteryReadyQueue : public SimReadyQueue
+{
+private:
+    const vector<SimJob> &jobs;
+    FenwickTree tickets;
+    Xoshiro256 rng;
+    int slice;
+    size_t queued;
+
+public:
+    LotteryReadyQueue(const vector<SimJob> &j, int timeQuantum, uint64_t seed)
+        : jobs(j), rng(seed), slice(max(1, timeQuantum)), queued(0)
+    {
+        tickets.assign(vector<long long>(j.size(), 0));
+    }
+
+    void push(int job)
+    {
+        tickets.add(job, ticketsFor(jobs[job].priority));
+        queued++;
+    }
+
+    int pop()
+    {
+        int job = (int)tickets.find((long long)(rng() % (uint64_t)tickets.total()));
+        tickets.add(job, -ticketsFor(jobs[job].priority));
+        queued--;
+        return job;
+    }
+
+    bool empty() const { return queued == 0; }
+    int quantum(int) const { return slice; }
+};
+
+// Stride scheduling: a job's pass grows by strideFor(priority) for each full
+// quantum it runs (pro rata for a shorter last slice), and the lowest pass
+// runs next, kept in a min-heap with ties going to the lower pid. A job
+// entering the queue starts no earlier than the global pass (the pass of the
+// last pick), so it cannot bank credit for time it was not runnable.
+class StrideReadyQueue : public SimReadyQueue
+{
+private:
+    struct Entry
+    {
+        long long pass;
+        int pid;
+        int job;
+    };
+
+    struct After
+    {
+        bool operator()(const Entry &a, const Entry &b) const
+        {
+            if (a.pass != b.pass)
+                return a.pass > b.pass;
+            return a.pid > b.pid;
+        }
+    };
+
+    const vector<SimJob> &jobs;
+    vector<long long> pass;
+    vector<Entry> heap;
+    long long globalPass;
+    int slice;
+
+public:
+    StrideReadyQueue(const vector<SimJob> &j, int timeQuantum)
+        : jobs(j), pass(j.size(), 0), globalPass(0), slice(max(1, timeQuantum)) {}
+
+    void push(int job)
+    {
+        pass[job] = max(pass[job], globalPass);
+        heap.push_back(Entry{pass[job], jobs[job].pid, job});
+        push_heap(heap.begin(), heap.end(), After());
+    }
+
+    int pop()
+    {
+        pop_heap(heap.begin(), heap.end(), After());
+        Entry entry = heap.back();
+        heap.pop_back();
+        globalPass = entry.pass;
+        const SimJob &job = jobs[entry.job];
+        pass[entry.job] += strideFor(job.priority) * min(slice, job.remainingBT) / slice;
+        return entry.job;
+    }
+
+    bool empty() const { return heap.empty(); }
+    int quantum(int) const { return slice; }
+};
+
+// Discrete-event CPU scheduling simulator. Arrivals and slice completions are
+// events on a time-ordered queue; the CPU is handed to the policy's next job
+// whenever it goes idle, and per-job timings are recorded until all complete.
+class SchedulerSimulator
+{
+private:
+    enum EventType
+    {
+        EVENT_ARRIVAL,   // Arrivals sort before slice ends at the same tick
+        EVENT_SLICE_END
+    };
+
+    struct Event
+    {
+        long long time;
+        int type;
+        long long seq;
+        int job;
+    };
+
+    struct EventAfter
+    {
+        bool operator()(const Event &a, const Event &b) const
+        {
+            if (a.time != b.time)
+                return a.time > b.time;
+            if (a.type != b.type)
+                return a.type > b.type;
+            return a.seq > b.seq;
+        }
+    };
+
+    // Nearest-rank percentile; reorders values
+    static long long percentile(vector<long long> &values, double fraction)
+    {
+        if (values.empty())
+            return 0;
+        size_t rank = (size_t)(fraction * values.size());
+        if (rank >= values.size())
+            rank = values.size() - 1;
+        nth_element(values.begin(), values.begin() + rank, values.end());
+        return values[rank];
+    }
+
+    static SimReadyQueue *makeReadyQueue(const SimulationOptions &options, const vector<SimJob> &jobs)
+    {
+        switch (options.policy)
+        {
+        case POLICY_PRIORITY:
+            return new HeapReadyQueue<JobHigherPriority>(JobHigherPriority{&jobs});
+        case POLICY_SJF:
+            return new HeapReadyQueue<JobShorter>(JobShorter{&jobs});
+        case POLICY_RR:
+            return new RoundRobinReadyQueue(jobs, options.timeQuantum, options.adaptiveQuantum);
+        case POLICY_MLQ:
+            return new MultilevelReadyQueue(jobs, options.mlqThreshold, options.timeQuantum, options.adaptiveQuantum);
+        case POLICY_MLFQ:
+            return new FeedbackReadyQueue(jobs, options.mlfqLevels, options.timeQuantum, options.boostInterval);
+        case POLICY_LOTTERY:
+            return new LotteryReadyQueue(jobs, options.timeQuantum, options.seed);
+        case POLICY_STRIDE:
+            return new StrideReadyQueue(jobs, options.timeQuantum);
+        case POLICY_SRTF:
+            return new PreemptiveReadyQueue<JobShorterRemaining>(JobShorterRemaining{&jobs});
+        case POLICY_EDF:
+            return new PreemptiveReadyQueue<JobEarlierDeadline>(JobEarlierDeadline{&jobs});
+        default:
+            return new HeapReadyQueue<JobArrivesFirst>(JobArrivesFirst{&jobs});
+        }
+    }
+
+public:
+    static SimulationResult run(vector<SimJob> jobs, const SimulationOptions &options)
+    {
+        chrono::steady_clock::time_point started = chrono::steady_clock::now();
+
+        SimulationResult result;
+        result.policy = options.policy;
+        result.makespan = result.busyTime = result.contextSwitches = result.dispatches = result.preemptions = result.events = 0;
+
+        // Arrivals are fed into the event queue one at a time in AT order
+        vector<int> arrivals(jobs.size()), priorities(jobs.size());
+        for (size_t i = 0; i < jobs.size(); i++)
+        {
+            jobs[i].remainingBT = jobs[i].burst;
+            jobs[i].firstRun = jobs[i].completion = -1;
+            arrivals[i] = (int)i;
+            priorities[i] = jobs[i].priority;
+        }
+        sort(arrivals.begin(), arrivals.end(), JobArrivesFirst{&jobs});
+        ShareLedger shares(priorities);
+
+        unique_ptr<SimReadyQueue> ready(makeReadyQueue(options, jobs));
+        priority_queue<Event, vector<Event>, EventAfter> events;
+        long long seq = 0;
+        size_t nextArrival = 0;
+        if (!arrivals.empty())
+            events.push(Event{jobs[arrivals[0]].AT, EVENT_ARRIVAL, seq++, arrivals[nextArrival++]});
+
+        int running = -1, lastRun = -1;
+        int sliceLength = 0;
+        long long sliceStart = 0, sliceEvent = -1; // Start and end-event seq of the running slice
+        long long lastEvent = 0;
+        bool preemptive = ready->preemptive();
+        while (!events.empty())
+        {
+            Event event = events.top();
+            events.pop();
+            result.events++;
+            long long now = event.time;
+            if (running >= 0)
+                shares.advance(now - lastEvent);
+            lastEvent = now;
+
+            if (event.type == EVENT_ARRIVAL)
+            {
+                ready->push(event.job);
+                shares.join(event.job);
+                if (nextArrival < arrivals.size())
+                {
+                    int job = arrivals[nextArrival++];
+                    events.push(Event{jobs[job].AT, EVENT_ARRIVAL, seq++, job});
+                }
+                if (preemptive && running >= 0)
+                {
+                    // Charge the running job up to now so it is ranked on what it has left
+                    SimJob &job = jobs[running];
+                    int ran = (int)(now - sliceStart);
+                    job.remainingBT -= ran;
+                    sliceLength -= ran;
+                    sliceStart = now;
+                    result.busyTime += ran;
+                    shares.charge(running, ran);
+                    if (sliceLength > 0 && ready->preempts(event.job, running))
+                    {
+                        // Its pending slice end goes stale
+                        shares.check(running);
+                        ready->push(running);
+                        result.preemptions++;
+                        if (options.trace)
+                            options.trace->record(TRACE_MOVE, job.pid, now, TRACE_QUEUE_RUNNING, TRACE_QUEUE_READY, job.remainingBT);
+                        running = -1;
+                        sliceEvent = -1;
+                    }
+                }
+            }
+            else if (event.seq == sliceEvent)
+            {
+                SimJob &job = jobs[event.job];
+                job.remainingBT -= sliceLength;
+                result.busyTime += sliceLength;
+                shares.charge(event.job, sliceLength);
+                shares.check(event.job);
+                if (job.remainingBT == 0)
+                {
+                    shares.leave(event.job);
+                    job.completion = now;
+                    if (options.trace)
+                        options.trace->record(TRACE_COMPLETE, job.pid, now);
+                }
+                else
+                {
+                    ready->push(event.job);
+                    if (options.trace)
+                        options.trace->record(TRACE_MOVE, job.pid, now, TRACE_QUEUE_RUNNING, TRACE_QUEUE_READY, job.remainingBT);
+                }
+                running = -1;
+            }
+
+            // Dispatch once every event at this tick has been applied
+            if (running < 0 && !ready->empty() && (events.empty() || events.top().time > now))
+            {
+                ready->advance(now);
+                running = ready->pop();
+                shares.check(running);
+                SimJob &job = jobs[running];
+                result.dispatches++;
+                if (lastRun >= 0 && lastRun != running)
+                    result.contextSwitches++;
+                lastRun = running;
+                if (job.firstRun < 0)
+                    job.firstRun = now;
+                int q = ready->quantum(running);
+                sliceLength = (q > 0 && q < job.remainingBT) ? q : job.remainingBT;
+                sliceStart = now;
+                sliceEvent = seq;
+                events.push(Event{now + sliceLength, EVENT_SLICE_END, seq++, running});
+                if (options.trace)
+                    options.trace->record(TRACE_DISPATCH, job.pid, now, TRACE_QUEUE_READY, TRACE_QUEUE_RUNNING, sliceLength, 0);
+            }
+        }
+
+        long long totalTurnaround = 0, totalWaiting = 0, totalResponse = 0;
+        result.maxWaiting = 0;
+        for (size_t i = 0; i < jobs.size(); i++)
+        {
+            totalTurnaround += jobs[i].turnaround();
+            totalWaiting += jobs[i].waiting();
+            totalResponse += jobs[i].response();
+            result.maxWaiting = max(result.maxWaiting, jobs[i].waiting());
+            result.makespan = max(result.makespan, jobs[i].completion);
+        }
+        vector<long long> turnarounds(jobs.size()), responses(jobs.size());
+        for (size_t i = 0; i < jobs.size(); i++)
+        {
+            turnarounds[i] = jobs[i].turnaround();
+            responses[i] = jobs[i].response();
+        }
+        result.p95Turnaround = percentile(turnarounds, 0.95);
+        result.p99Turnaround = percentile(turnarounds, 0.99);
+        result.p95Response = percentile(responses, 0.95);
+        result.p99Response = percentile(responses, 0.99);
+        vector<long long> lateness;
+        long long totalLateness = 0;
+        result.deadlineMisses = 0;
+        result.maxLateness = 0;
+        for (size_t i = 0; i < jobs.size(); i++)
+            if (jobs[i].deadline >= 0)
+            {
+                long long late = jobs[i].completion - jobs[i].deadline;
+                result.maxLateness = lateness.empty() ? late : max(result.maxLateness, late);
+                lateness.push_back(late);
+                totalLateness += late;
+                if (late > 0)
+                    result.deadlineMisses++;
+            }
+        result.deadlineJobs = lateness.size();
+        result.avgLateness = lateness.empty() ? 0.0 : (double)totalLateness / lateness.size();
+        result.p95Lateness = percentile(lateness, 0.95);
+        result.p99Lateness = percentile(lateness, 0.99);
+        size_t n = jobs.empty() ? 1 : jobs.size();
+        result.avgTurnaround = (double)totalTurnaround / n;
+        result.avgWaiting = (double)totalWaiting / n;
+        result.avgResponse = (double)totalResponse / n;
+        result.tenants = shares.shares();
+        result.fairnessError = shares.fairnessError();
+        result.jobs.swap(jobs);
+        result.elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        Instrumentation::add(COUNTER_SIM_DISPATCH + options.policy, result.dispatches);
+        Instrumentation::addTime(TIMER_SIMULATION, (uint64_t)(result.elapsedSeconds * 1e9));
+        return result;
+    }
+};
+
+// Settings for the multi-core simulator
+struct SmpOptions
+{
+    int cpus;
+    int timeQuantum;     // Round-Robin slice on every CPU
+    int balanceInterval; // Ticks between load-balancing passes
+    bool pushMigration;  // Move queued jobs from overloaded CPUs to underloaded ones
+    bool workStealing;   // Idle CPUs pull half the queue of the busiest CPU
+    unsigned threads;    // Host threads advancing CPUs between balancing passes (at most one per 32 CPUs)
+
+    SmpOptions() : cpus(4), timeQuantum(10), balanceInterval(10), pushMigration(true), workStealing(true), threads(1) {}
+};
+
+struct CpuStats
+{
+    long long busyTime;
+    long long dispatches;
+    long long contextSwitches;
+    long long migrationsIn;
+    long long migrationsOut;
+};
+
+struct SmpResult
+{
+    vector<SimJob> jobs;
+    vector<CpuStats> cpus;
+    long long makespan;
+    long long migrations;    // Jobs moved by push migration
+    long long steals;        // Jobs moved by work stealing
+    long long balancePasses;
+    double avgImbalance;     // Mean over balancing passes of max - min CPU load
+    long long maxImbalance;
+    double avgTurnaround;
+    double avgWaiting;
+    double avgResponse;
+    double elapsedSeconds;
+
+    double utilization(size_t cpu) const { return makespan > 0 ? (double)cpus[cpu].busyTime / makespan : 0.0; }
+};
+
+// Multi-core scheduling simulator. Every CPU runs Round-Robin over its own
+// run queue. Time advances in epochs of balanceInterval ticks: within an epoch
+// CPUs are independent, so they are advanced on parallel host threads, and at
+// each epoch boundary new arrivals are placed and the balancer runs alone.
+// The outcome does not depend on the number of host threads.
+class SmpSimulator
+{
+private:
+    struct Cpu
+    {
+        deque<int> queue;
+        vector<int> arrivals; // Placed jobs not yet arrived, in AT order
+        size_t nextArrival;
+        long long time;
+        int running;
+        int lastRun;
+        int sliceLeft;
+        long long completed;
+        CpuStats stats;
+    };
+
+    // Reusable barrier for the CPU worker threads
+    class Barrier
+    {
+    private:
+        mutex lock;
+        condition_variable changed;
+        unsigned parties;
+        unsigned waiting;
+        unsigned long long generation;
+
+    public:
+        explicit Barrier(unsigned count) : parties(count), waiting(0), generation(0) {}
+
+        void wait()
+        {
+            unique_lock<mutex> guard(lock);
+            unsigned long long arrived = generation;
+            if (++waiting == parties)
+            {
+                waiting = 0;
+                generation++;
+                changed.notify_all();
+                return;
+            }
+            changed.wait(guard, [this, arrived] { return generation != arrived; });
+        }
+    };
+
+    vector<SimJob> &jobs;
+    const SmpOptions &options;
+    vector<Cpu> cpus;
+
+    SmpSimulator(vector<SimJob> &j, const SmpOptions &o) : jobs(j), options(o), cpus(o.cpus)
+    {
+        for (size_t c = 0; c < cpus.size(); c++)
+        {
+            cpus[c].nextArrival = 0;
+            cpus[c].time = 0;
+            cpus[c].running = cpus[c].lastRun = -1;
+            cpus[c].sliceLeft = 0;
+            cpus[c].completed = 0;
+            cpus[c].stats = CpuStats{0, 0, 0, 0, 0};
+        }
+    }
+
+    static size_t load(const Cpu &cpu)
+    {
+        return cpu.queue.size() + (cpu.running >= 0 ? 1 : 0) + (cpu.arrivals.size() - cpu.nextArrival);
+    }
+
+    void admitArrivals(Cpu &cpu)
+    {
+        while (cpu.nextArrival < cpu.arrivals.size() && jobs[cpu.arrivals[cpu.nextArrival]].AT <= cpu.time)
+            cpu.queue.push_back(cpu.arrivals[cpu.nextArrival++]);
+        if (cpu.nextArrival == cpu.arrivals.size())
+        {
+            cpu.arrivals.clear();
+            cpu.nextArrival = 0;
+        }
+    }
+
+    // Run one CPU from the start of the epoch up to epochEnd
+    void advance(Cpu &cpu, long long epochEnd)
+    {
+        cpu.time = max(cpu.time, epochEnd - options.balanceInterval);
+        while (cpu.time < epochEnd)
+        {
+            admitArrivals(cpu);
+            if (cpu.running < 0)
+            {
+                if (cpu.queue.empty())
+                {
+                    long long next = cpu.nextArrival < cpu.arrivals.size() ? jobs[cpu.arrivals[cpu.nextArrival]].AT : epochEnd;
+                    cpu.time = min(next, epochEnd);
+                    continue;
+                }
+                cpu.running = cpu.queue.front();
+                cpu.queue.pop_front();
+                SimJob &job = jobs[cpu.running];
+                if (job.firstRun < 0)
+                    job.firstRun = cpu.time;
+                cpu.sliceLeft = min(options.timeQuantum, job.remainingBT);
+                cpu.stats.dispatches++;
+                if (cpu.lastRun >= 0 && cpu.lastRun != cpu.running)
+                    cpu.stats.contextSwitches++;
+                cpu.lastRun = cpu.running;
+            }
+            SimJob &job = jobs[cpu.running];
+            int step = (int)min((long long)cpu.sliceLeft, epochEnd - cpu.time);
+            cpu.time += step;
+            cpu.sliceLeft -= step;
+            job.remainingBT -= step;
+            cpu.stats.busyTime += step;
+            if (job.remainingBT == 0)
+            {
+                job.completion = cpu.time;
+                cpu.completed++;
+                cpu.running = -1;
+            }
+            else if (cpu.sliceLeft == 0)
+            {
+                // Arrivals during the slice queue ahead of the preempted job
+                admitArrivals(cpu);
+                cpu.queue.push_back(cpu.running);
+                cpu.running = -1;
+            }
+        }
+    }
+
+    // Take the queued job nearest the tail of a CPU's queue that may run
+    // elsewhere. The search passes over pinned jobs, so it is O(queue) at
+    // worst. erase shifts the shorter side of the deque, which is cheap near
+    // the tail, and keeps the remaining jobs in Round-Robin order.
+    static int takeMigratable(Cpu &cpu, const vector<SimJob> &jobs)
+    {
+        for (deque<int>::iterator it = cpu.queue.end(); it != cpu.queue.begin();)
+        {
+            --it;
+            if (jobs[*it].cpu < 0)
+            {
+                int job = *it;
+                cpu.queue.erase(it);
+                return job;
+            }
+        }
+        return -1;
+    }
+
+    bool move(size_t from, size_t to)
+    {
+        int job = takeMigratable(cpus[from], jobs);
+        if (job < 0)
+            return false;
+        cpus[to].queue.push_back(job);
+        cpus[from].stats.migrationsOut++;
+        cpus[to].stats.migrationsIn++;
+        return true;
+    }
+
+    // Even out queue lengths: CPUs above the ceiling of the mean load give
+    // queued jobs to CPUs below its floor
+    long long pushMigrate()
+    {
+        size_t total = 0;
+        for (size_t c = 0; c < cpus.size(); c++)
+            total += load(cpus[c]);
+        size_t low = total / cpus.size(), high = (total + cpus.size() - 1) / cpus.size();
+        long long moved = 0;
+        size_t receiver = 0;
+        for (size_t donor = 0; donor < cpus.size(); donor++)
+            while (load(cpus[donor]) > high)
+            {
+                while (receiver < cpus.size() && load(cpus[receiver]) >= low)
+                    receiver++;
+                if (receiver == cpus.size())
+                    return moved;
+                if (!move(donor, receiver))
+                    break; // Only pinned or not yet arrived jobs left
+                moved++;
+            }
+        return moved;
+    }
+
+    // Each idle CPU takes half of the queue of the currently busiest CPU
+    long long stealWork()
+    {
+        priority_queue<pair<size_t, size_t>> busiest;
+        vector<size_t> idle;
+        for (size_t c = 0; c < cpus.size(); c++)
+        {
+            if (load(cpus[c]) == 0)
+                idle.push_back(c);
+            else if (cpus[c].queue.size() > 1)
+                busiest.push(make_pair(cpus[c].queue.size(), c));
+        }
+        long long stolen = 0;
+        for (size_t i = 0; i < idle.size() && !busiest.empty(); i++)
+        {
+            size_t victim = busiest.top().second;
+            busiest.pop();
+            size_t share = cpus[victim].queue.size() / 2;
+            for (size_t n = 0; n < share && move(victim, idle[i]); n++)
+                stolen++;
+            if (cpus[victim].queue.size() > 1)
+                busiest.push(make_pair(cpus[victim].queue.size(), victim));
+        }
+        return stolen;
+    }
+
+public:
+    static SmpResult run(vector<SimJob> jobs, const SmpOptions &requested)
+    {
+        chrono::steady_clock::time_point started = chrono::steady_clock::now();
+        SmpOptions options = requested;
+        options.cpus = max(1, options.cpus);
+        options.timeQuantum = max(1, options.timeQuantum);
+        options.balanceInterval = max(1, options.balanceInterval);
+        // Below a few dozen CPUs per thread the barrier costs more than it saves
+        options.threads = max(1u, min(options.threads, (unsigned)options.cpus / 32));
+
+        vector<int> arrivals(jobs.size());
+        for (size_t i = 0; i < jobs.size(); i++)
+        {
+            jobs[i].remainingBT = jobs[i].burst;
+            jobs[i].firstRun = jobs[i].completion = -1;
+            if (jobs[i].cpu >= options.cpus)
+                jobs[i].cpu = -1;
+            arrivals[i] = (int)i;
+        }
+        sort(arrivals.begin(), arrivals.end(), JobArrivesFirst{&jobs});
+
+        SmpSimulator sim(jobs, options);
+        SmpResult result;
+        result.migrations = result.steals = result.balancePasses = result.maxImbalance = 0;
+        double imbalanceSum = 0;
+
+        // Jobs that need no CPU time complete on arrival
+        long long runnable = 0, completed = 0;
+        for (size_t i = 0; i < jobs.size(); i++)
+        {
+            if (jobs[i].burst <= 0)
+                jobs[i].firstRun = jobs[i].completion = jobs[i].AT;
+            else
+                runnable++;
+        }
+
+        Barrier barrier(options.threads);
+        long long epochEnd = 0;
+        bool finished = false;
+        size_t nextArrival = 0;
+
+        // Host thread t advances CPUs t, t + threads, ...
+        auto worker = [&](unsigned t) {
+            while (true)
+            {
+                barrier.wait();
+                if (finished)
+                    return;
+                for (size_t c = t; c < sim.cpus.size(); c += options.threads)
+                    sim.advance(sim.cpus[c], epochEnd);
+                barrier.wait();
+            }
+        };
+        vector<thread> threads;
+        for (unsigned t = 1; t < options.threads; t++)
+            threads.emplace_back(worker, t);
+
+        while (completed < runnable)
+        {
+            long long epochStart = epochEnd;
+            bool busy = false;
+            for (size_t c = 0; c < sim.cpus.size() && !busy; c++)
+                busy = load(sim.cpus[c]) > 0;
+            // Skip idle stretches straight to the epoch of the next arrival
+            while (nextArrival < arrivals.size() && jobs[arrivals[nextArrival]].burst <= 0)
+                nextArrival++;
+            if (!busy && nextArrival < arrivals.size())
+            {
+                long long at = jobs[arrivals[nextArrival]].AT;
+                epochStart = max(epochStart, at - at % options.balanceInterval);
+            }
+            epochEnd = epochStart + options.balanceInterval;
+
+            // Place arrivals of this epoch on their pinned CPU or spread them by PID
+            for (; nextArrival < arrivals.size() && jobs[arrivals[nextArrival]].AT < epochEnd; nextArrival++)
+            {
+                const SimJob &job = jobs[arrivals[nextArrival]];
+                if (job.burst <= 0)
+                    continue;
+                size_t target = job.cpu >= 0 ? job.cpu : (size_t)job.pid % sim.cpus.size();
+                sim.cpus[target].arrivals.push_back(arrivals[nextArrival]);
+            }
+
+            if (options.pushMigration)
+                result.migrations += sim.pushMigrate();
+            if (options.workStealing)
+                result.steals += sim.stealWork();
+            size_t lo = SIZE_MAX, hi = 0;
+            for (size_t c = 0; c < sim.cpus.size(); c++)
+            {
+                lo = min(lo, load(sim.cpus[c]));
+                hi = max(hi, load(sim.cpus[c]));
+            }
+            imbalanceSum += hi - lo;
+            result.maxImbalance = max(result.maxImbalance, (long long)(hi - lo));
+            result.balancePasses++;
+
+            barrier.wait();
+            for (size_t c = 0; c < sim.cpus.size(); c += options.threads)
+                sim.advance(sim.cpus[c], epochEnd);
+            barrier.wait();
+
+            completed = 0;
+            for (size_t c = 0; c < sim.cpus.size(); c++)
+                completed += sim.cpus[c].completed;
+        }
+        finished = true;
+        barrier.wait();
+        for (size_t t = 0; t < threads.size(); t++)
+            threads[t].join();
+
+        long long totalTurnaround = 0, totalWaiting = 0, totalResponse = 0;
+        result.makespan = 0;
+        for (size_t i = 0; i < jobs.size(); i++)
+        {
+            totalTurnaround += jobs[i].turnaround();
+            totalWaiting += jobs[i].waiting();
+            totalResponse += jobs[i].response();
+            result.makespan = max(result.makespan, jobs[i].completion);
+        }
+        size_t n = jobs.empty() ? 1 : jobs.size();
+        result.avgTurnaround = (double)totalTurnaround / n;
+        result.avgWaiting = (double)totalWaiting / n;
+        result.avgResponse = (double)totalResponse / n;
+        result.avgImbalance = result.balancePasses ? imbalanceSum / result.balancePasses : 0.0;
+        for (size_t c = 0; c < sim.cpus.size(); c++)
+            result.cpus.push_back(sim.cpus[c].stats);
+        result.jobs.swap(jobs);
+        result.elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        long long dispatches = 0;
+        for (const CpuStats &cpu : result.cpus)
+            dispatches += cpu.dispatches;
+        Instrumentation::add(COUNTER_SIM_DISPATCH + POLICY_RR, dispatches);
+        Instrumentation::addTime(TIMER_SIMULATION, (uint64_t)(result.elapsedSeconds * 1e9));
+        return result;
+    }
+};
+
+// Outcome of running a page reference string through a replacement policy
+struct ReplacementResult
+{
+    long long hits;
+    long long faults;
+    vector<int> faultSequence; // Pages that faulted, in reference order (when recorded)
+    vector<int> frames;        // Resident pages by frame slot at the end of the run
+
+    ReplacementResult() : hits(0), faults(0) {}
+    long long references() const { return hits + faults; }
+    double faultRate() const { return references() ? (double)faults / references() : 0.0; }
+};
+
+// Page replacement algorithms available to the replacement driver
+enum ReplacementAlgorithm
+{
+    REPLACEMENT_LRU,
+    REPLACEMENT_FIFO,
+    REPLACEMENT_OPTIMAL,
+    REPLACEMENT_CLOCK,
+    REPLACEMENT_LFU,
+    REPLACEMENT_ARC,
+    REPLACEMENT_COUNT
+};
+
+const char *replacementName(ReplacementAlgorithm algorithm)
+{
+    static const char *names[REPLACEMENT_COUNT] = {"LRU", "FIFO", "Optimal", "Clock", "LFU", "ARC"};
+    return names[algorithm];
+}
+
+// A page replacement policy managing a fixed number of frames
+class ReplacementPolicy
+{
+public:
+    virtual ~ReplacementPolicy() {}
+    // Reference a page; returns true on a hit
+    virtual bool access(int page) = 0;
+    // Resident pages by frame slot
+    virtual vector<int> residentPages() const = 0;
+};
+
+// Page number -> value (-1 if absent). Small non-negative page numbers use a
+// direct array that grows on demand; anything else falls back to a hash map.
+template <typename Value>
+class PageMap
+{
+private:
+    static const int DENSE_LIMIT = 1 << 22;
+    vector<Value> dense;
+    unordered_map<int, Value> sparse;
+
+public:
+    Value find(int page) const
+    {
+        if (page >= 0 && page < DENSE_LIMIT)
+            return page < (int)dense.size() ? dense[page] : -1;
+        typename unordered_map<int, Value>::const_iterator it = sparse.find(page);
+        return it == sparse.end() ? -1 : it->second;
+    }
+
+    void set(int page, Value slot)
+    {
+        if (page >= 0 && page < DENSE_LIMIT)
+        {
+            if (page >= (int)dense.size())
+                dense.resize(min(max((size_t)page + 1, dense.size() * 2), (size_t)DENSE_LIMIT), -1);
+            dense[page] = slot;
+        }
+        else
+            sparse[page] = slot;
+    }
+
+    void erase(int page)
+    {
+        if (page >= 0 && page < DENSE_LIMIT)
+            dense[page] = -1;
+        else
+            sparse.erase(page);
+    }
+};
+
+typedef PageMap<int> PageSlotMap; // Page number -> frame slot
+
+// LRU replacement in O(1) per reference: a page -> slot map plus an
+// intrusive recency list threaded through the frame slots.
+class LRUReplacer : public ReplacementPolicy
+{
+private:
+    int capacity;
+    int used;
+    int mru, lru;           // Ends of the recency list
+    vector<int> pages;      // Page held by each slot
+    vector<int> newer, older;
+    PageSlotMap slotOf;
+
+    void unlink(int slot)
+    {
+        if (newer[slot] >= 0)
+            older[newer[slot]] = older[slot];
+        else
+            mru = older[slot];
+        if (older[slot] >= 0)
+            newer[older[slot]] = newer[slot];
+        else
+            lru = newer[slot];
+    }
+
+    void pushMostRecent(int slot)
+    {
+        newer[slot] = -1;
+        older[slot] = mru;
+        if (mru >= 0)
+            newer[mru] = slot;
+        else
+            lru = slot;
+        mru = slot;
+    }
+
+public:
+    explicit LRUReplacer(int numFrames)
+        : capacity(numFrames), used(0), mru(-1), lru(-1), pages(numFrames), newer(numFrames), older(numFrames) {}
+
+    // Reference a page; returns true on a hit
+    bool access(int page)
+    {
+        int slot = slotOf.find(page);
+        if (slot >= 0)
+        {
+            if (slot != mru)
+            {
+                unlink(slot);
+                pushMostRecent(slot);
+            }
+            return true;
+        }
+        if (used < capacity)
+            slot = used++;
+        else
+        {
+            slot = lru;
+            unlink(slot);
+            slotOf.erase(pages[slot]);
+        }
+        pages[slot] = page;
+        slotOf.set(page, slot);
+        pushMostRecent(slot);
+        return false;
+    }
+
+    vector<int> residentPages() const { return vector<int>(pages.begin(), pages.begin() + used); }
+};
+
+// FIFO replacement: frames are refilled in the order they were loaded
+class FIFOReplacer : public ReplacementPolicy
+{
+private:
+    int capacity;
+    int used;
+    int oldest; // Next slot to be replaced once all frames are full
+    vector<int> pages;
+    PageSlotMap slotOf;
+
+public:
+    explicit FIFOReplacer(int numFrames) : capacity(numFrames), used(0), oldest(0), pages(numFrames) {}
+
+    bool access(int page)
+    {
+        if (slotOf.find(page) >= 0)
+            return true;
+        int slot;
+        if (used < capacity)
+            slot = used++;
+        else
+        {
+            slot = oldest;
+            oldest = (oldest + 1) % capacity;
+            slotOf.erase(pages[slot]);
+        }
+        pages[slot] = page;
+        slotOf.set(page, slot);
+        return false;
+    }
+
+    vector<int> residentPages() const { return vector<int>(pages.begin(), pages.begin() + used); }
+};
+
+// Min-heap of (key, slot) entries with lazy invalidation. Re-keying a slot
+// pushes a fresh entry; outdated ones are discarded when they reach the top,
+// and the heap is rebuilt from the live keys when they pile up.
+template <typename Key>
+class LazySlotHeap
+{
+private:
+    typedef pair<Key, int> Entry;
+    vector<Entry> heap;
+    vector<Key> current;
+    vector<bool> live;
+
+public:
+    explicit LazySlotHeap(int slots) : current(slots), live(slots, false) {}
+
+    void set(int slot, const Key &key)
+    {
+        current[slot] = key;
+        live[slot] = true;
+        heap.push_back(Entry(key, slot));
+        push_heap(heap.begin(), heap.end(), greater<Entry>());
+        if (heap.size() > 4 * current.size() + 64)
+        {
+            heap.clear();
+            for (size_t s = 0; s < current.size(); s++)
+                if (live[s])
+                    heap.push_back(Entry(current[s], (int)s));
+            make_heap(heap.begin(), heap.end(), greater<Entry>());
+        }
+    }
+
+    // Remove and return the live slot with the smallest key
+    int popMin()
+    {
+        while (true)
+        {
+            Entry top = heap.front();
+            pop_heap(heap.begin(), heap.end(), greater<Entry>());
+            heap.pop_back();
+            if (live[top.second] && current[top.second] == top.first)
+            {
+                live[top.second] = false;
+                return top.second;
+            }
+        }
+    }
+};
+
+// Belady's optimal replacement: evict the page whose next use is furthest away.
+// Next-use positions are precomputed in one backward pass over the trace, so
+// the trace passed to access() must be the one given to the constructor.
+class OptimalReplacer : public ReplacementPolicy
+{
+private:
+    int capacity;
+    int used;
+    size_t position;
+    vector<long long> nextUse; // Index of the next reference to the same page (LLONG_MAX if none)
+    vector<int> pages;
+    PageSlotMap slotOf;
+    LazySlotHeap<long long> furthest; // Keyed on -nextUse so the minimum is the furthest use
+
+public:
+    OptimalReplacer(int numFrames, const vector<int> &pageReferences)
+        : capacity(numFrames), used(0), position(0), nextUse(pageReferences.size()), pages(numFrames), furthest(numFrames)
+    {
+        PageMap<long long> lastSeen;
+        for (size_t i = pageReferences.size(); i-- > 0;)
+        {
+            long long seen = lastSeen.find(pageReferences[i]);
+            nextUse[i] = seen >= 0 ? seen : LLONG_MAX;
+            lastSeen.set(pageReferences[i], (long long)i);
+        }
+    }
+
+    bool access(int page)
+    {
+        long long next = position < nextUse.size() ? nextUse[position] : LLONG_MAX;
+        position++;
+        int slot = slotOf.find(page);
+        if (slot >= 0)
+        {
+            furthest.set(slot, -next);
+            return true;
+        }
+        if (used < capacity)
+            slot = used++;
+        else
+        {
+            slot = furthest.popMin();
+            slotOf.erase(pages[slot]);
+        }
+        pages[slot] = page;
+        slotOf.set(page, slot);
+        furthest.set(slot, -next);
+        return false;
+    }
+
+    vector<int> residentPages() const { return vector<int>(pages.begin(), pages.begin() + used); }
+};
+
+// Clock (second-chance) replacement: a hand sweeps the frames, clearing
+// reference bits until it finds an unreferenced victim
+class ClockReplacer : public ReplacementPolicy
+{
+private:
+    int capacity;
+    int used;
+    int hand;
+    vector<int> pages;
+    vector<char> referenced;
+    PageSlotMap slotOf;
+
+public:
+    explicit ClockReplacer(int numFrames) : capacity(numFrames), used(0), hand(0), pages(numFrames), referenced(numFrames, 0) {}
+
+    bool access(int page)
+    {
+        int slot = slotOf.find(page);
+        if (slot >= 0)
+        {
+            referenced[slot] = 1;
+            return true;
+        }
+        if (used < capacity)
+            slot = used++;
+        else
+        {
+            while (referenced[hand])
+            {
+                referenced[hand] = 0;
+                hand = (hand + 1) % capacity;
+            }
+            slot = hand;
+            hand = (hand + 1) % capacity;
+            slotOf.erase(pages[slot]);
+        }
+        pages[slot] = page;
+        referenced[slot] = 1;
+        slotOf.set(page, slot);
+        return false;
+    }
+
+    vector<int> residentPages() const { return vector<int>(pages.begin(), pages.begin() + used); }
+};
+
+// LFU replacement: evict the least frequently used page, breaking ties by
+// least recent use. Frequencies reset when a page is evicted.
+class LFUReplacer : public ReplacementPolicy
+{
+private:
+    int capacity;
+    int used;
+    long long clock;
+    vector<int> pages;
+    vector<long long> frequency;
+    PageSlotMap slotOf;
+    LazySlotHeap<pair<long long, long long>> leastUsed; // Keyed on (frequency, last use)
+
+    void touch(int slot)
+    {
+        frequency[slot]++;
+        leastUsed.set(slot, make_pair(frequency[slot], clock));
+    }
+
+public:
+    explicit LFUReplacer(int numFrames)
+        : capacity(numFrames), used(0), clock(0), pages(numFrames), frequency(numFrames, 0), leastUsed(numFrames) {}
+
+    bool access(int page)
+    {
+        clock++;
+        int slot = slotOf.find(page);
+        if (slot >= 0)
+        {
+            touch(slot);
+            return true;
+        }
+        if (used < capacity)
+            slot = used++;
+        else
+        {
+            slot = leastUsed.popMin();
+            slotOf.erase(pages[slot]);
+        }
+        pages[slot] = page;
+        frequency[slot] = 0;
+        slotOf.set(page, slot);
+        touch(slot);
+        return false;
+    }
+
+    vector<int> residentPages() const { return vector<int>(pages.begin(), pages.begin() + used); }
+};
+
+// Adaptive Replacement Cache (Megiddo & Modha). Resident pages live in T1
+// (seen once recently) or T2 (seen at least twice); B1 and B2 remember pages
+// recently evicted from each, and hits there shift the target size p of T1.
+class ARCReplacer : public ReplacementPolicy
+{
+private:
+    enum ListId
+    {
+        T1,
+        T2,
+        B1,
+        B2,
+        LIST_COUNT
+    };
+
+    struct Node
+    {
+        int page;
+        int list;
+        int slot; // Frame slot while resident, -1 for ghost entries
+        int prev, next;
+    };
+
+    struct List
+    {
+        int head, tail; // head = MRU, tail = LRU
+        int size;
+    };
+
+    int capacity;
+    int target; // Adaptive target size of T1
+    vector<Node> nodes;
+    vector<int> freeNodes;
+    vector<int> slotPage;
+    vector<bool> occupied;
+    vector<int> freeSlots;
+    List lists[LIST_COUNT];
+    PageSlotMap nodeOf;
+
+    void detach(int n)
+    {
+        Node &node = nodes[n];
+        List &list = lists[node.list];
+        if (node.prev >= 0)
+            nodes[node.prev].next = node.next;
+        else
+            list.head = node.next;
+        if (node.next >= 0)
+            nodes[node.next].prev = node.prev;
+        else
+            list.tail = node.prev;
+        list.size--;
+    }
+
+    void attachMostRecent(int n, int listId)
+    {
+        Node &node = nodes[n];
+        List &list = lists[listId];
+        node.list = listId;
+        node.prev = -1;
+        node.next = list.head;
+        if (list.head >= 0)
+            nodes[list.head].prev = n;
+        else
+            list.tail = n;
+        list.head = n;
+        list.size++;
+    }
+
+    // Drop the LRU entry of a ghost list entirely
+    void discardLeastRecent(int listId)
+    {
+        int n = lists[listId].tail;
+        detach(n);
+        nodeOf.erase(nodes[n].page);
+        freeNodes.push_back(n);
+    }
+
+    // Evict the LRU page of a resident list, remembering it in ghost list
+    void evictLeastRecent(int from, int ghost)
+    {
+        int n = lists[from].tail;
+        detach(n);
+        freeSlots.push_back(nodes[n].slot);
+        occupied[nodes[n].slot] = false;
+        nodes[n].slot = -1;
+        attachMostRecent(n, ghost);
+    }
+
+    void replace(bool inB2)
+    {
+        int t1 = lists[T1].size;
+        if (t1 > 0 && (t1 > target || (inB2 && t1 == target)))
+            evictLeastRecent(T1, B1);
+        else
+            evictLeastRecent(T2, B2);
+    }
+
+    // Give a node a free frame slot
+    void load(int n)
+    {
+        int slot = freeSlots.back();
+        freeSlots.pop_back();
+        nodes[n].slot = slot;
+        slotPage[slot] = nodes[n].page;
+        occupied[slot] = true;
+    }
+
+public:
+    explicit ARCReplacer(int numFrames) : capacity(numFrames), target(0), slotPage(numFrames), occupied(numFrames, false)
+    {
+        nodes.reserve(2 * numFrames);
+        for (int s = numFrames - 1; s >= 0; s--)
+            freeSlots.push_back(s);
+        for (int l = 0; l < LIST_COUNT; l++)
+            lists[l].head = lists[l].tail = -1, lists[l].size = 0;
+    }
+
+    bool access(int page)
+    {
+        int n = nodeOf.find(page);
+        if (n >= 0 && (nodes[n].list == T1 || nodes[n].list == T2))
+        {
+            detach(n);
+            attachMostRecent(n, T2);
+            return true;
+        }
+        if (n >= 0)
+        {
+            // Ghost hit: adapt the target, make room and promote to T2
+            bool inB2 = nodes[n].list == B2;
+            int b1 = lists[B1].size, b2 = lists[B2].size;
+            if (inB2)
+                target = max(0, target - max(b1 / b2, 1));
+            else
+                target = min(capacity, target + max(b2 / b1, 1));
+            detach(n);
+            if (freeSlots.empty())
+                replace(inB2);
+            load(n);
+            attachMostRecent(n, T2);
+            return false;
+        }
+
+        // Page not seen recently
+        int l1 = lists[T1].size + lists[B1].size;
+        int total = l1 + lists[T2].size + lists[B2].size;
+        if (l1 == capacity)
+        {
+            if (lists[T1].size < capacity)
+            {
+                discardLeastRecent(B1);
+                replace(false);
+            }
+            else
+            {
+                evictLeastRecent(T1, B1);
+                discardLeastRecent(B1);
+            }
+        }
+        else if (total >= capacity)
+        {
+            if (total == 2 * capacity)
+                discardLeastRecent(B2);
+            if (freeSlots.empty())
+                replace(false);
+        }
+
+        if (freeNodes.empty())
+        {
+            nodes.push_back(Node());
+            n = (int)nodes.size() - 1;
+        }
+        else
+        {
+            n = freeNodes.back();
+            freeNodes.pop_back();
+        }
+        nodes[n].page = page;
+        nodeOf.set(page, n);
+        load(n);
+        attachMostRecent(n, T1);
+        return false;
+    }
+
+    vector<int> residentPages() const
+    {
+        vector<int> resident;
+        for (size_t s = 0; s < slotPage.size(); s++)
+            if (occupied[s])
+                resident.push_back(slotPage[s]);
+        return resident;
+    }
+};
+
+ReplacementPolicy *makeReplacementPolicy(ReplacementAlgorithm algorithm, int numFrames, const vector<int> &pageReferences)
+{
+    switch (algorithm)
+    {
+    case REPLACEMENT_FIFO:
+        return new FIFOReplacer(numFrames);
+    case REPLACEMENT_OPTIMAL:
+        return new OptimalReplacer(numFrames, pageReferences);
+    case REPLACEMENT_CLOCK:
+        return new ClockReplacer(numFrames);
+    case REPLACEMENT_LFU:
+        return new LFUReplacer(numFrames);
+    case REPLACEMENT_ARC:
+        return new ARCReplacer(numFrames);
+    default:
+        return new LRUReplacer(numFrames);
+    }
+}
+
+// Feed a block of references to a policy; base is the index of the first
+// one. Faults are traced with the reference index as their time.
+void replayReferences(ReplacementPolicy &policy, const int *pageReferences, size_t count, long long base, ReplacementResult &result, bool recordFaults, TraceWriter *trace)
+{
+    long long faultsBefore = result.faults;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (policy.access(pageReferences[i]))
+            result.hits++;
+        else
+        {
+            result.faults++;
+            if (recordFaults)
+                result.faultSequence.push_back(pageReferences[i]);
+            if (trace)
+            {
+                long long index = base + (long long)i;
+                trace->record(TRACE_PAGE_FAULT, 0, index, pageReferences[i], (int)(uint32_t)index, (int)(index >> 32));
+            }
+        }
+    }
+    long long faults = result.faults - faultsBefore;
+    Instrumentation::add(COUNTER_PAGE_HIT, count - faults);
+    Instrumentation::add(COUNTER_PAGE_FAULT, faults);
+}
+
+// Run a reference string through a replacement policy
+ReplacementResult runReplacement(ReplacementPolicy &policy, const vector<int> &pageReferences, bool recordFaults, TraceWriter *trace = nullptr)
+{
+    ScopedTimer timer(TIMER_REPLACEMENT);
+    ReplacementResult result;
+    replayReferences(policy, pageReferences.data(), pageReferences.size(), 0, result, recordFaults, trace);
+    result.frames = policy.residentPages();
+    return result;
+}
+
+// Run a reference string through one replacement algorithm with numFrames frames
+ReplacementResult runReplacement(ReplacementAlgorithm algorithm, int numFrames, const vector<int> &pageReferences, bool recordFaults, TraceWriter *trace = nullptr)
+{
+    unique_ptr<ReplacementPolicy> policy(makeReplacementPolicy(algorithm, numFrames, pageReferences));
+    return runReplacement(*policy, pageReferences, recordFaults, trace);
+}
+
+const char PAGE_TRACE_MAGIC[8] = {'E', 'G', 'L', 'P', 'A', 'G', 'E', 'S'};
+
+// Sequential reader for page reference traces. Text traces hold integers
+// separated by whitespace, and any other character fails the trace; binary traces are PAGE_TRACE_MAGIC
+// followed by native-endian int32 references. The file is mapped one window
+// at a time (read in blocks where mmap is unavailable) and parsed with a
+// hand-rolled scanner, so memory use does not grow with trace length.
+class PageTraceReader
+{
+private:
+    static const size_t WINDOW = 16 << 20; // Multiple of the page size
+
+#ifdef _WIN32
+    ifstream file;
+    vector<char> block;
+#else
+    int fd;
+    char *mapped;
+    size_t mappedLength;
+#endif
+    size_t fileSize;
+    size_t offset;      // File offset of the next window
+    const char *cursor; // Unread part of the current window
+    const char *end;
+    bool binary;
+    bool failed;
+
+    // Text scanner state, kept across window boundaries
+    long long value;
+    bool negative;
+    bool inNumber;
+
+    void releaseWindow()
+    {
+#ifndef _WIN32
+        if (mapped)
+            munmap(mapped, mappedLength);
+        mapped = nullptr;
+#endif
+        cursor = end = nullptr;
+    }
+
+    // A malformed text reference, or one outside the int range, ends the
+    // trace as a failure
+    void reject()
+    {
+        failed = true;
+        releaseWindow();
+        offset = fileSize;
+        inNumber = false;
+    }
+
+    bool loadWindow()
+    {
+        releaseWindow();
+        if (offset >= fileSize)
+            return false;
+        size_t length = min(WINDOW, fileSize - offset);
+#ifdef _WIN32
+        block.resize(length);
+        if (!file.read(block.data(), length))
+        {
+            failed = true;
+            return false;
+        }
+        cursor = block.data();
+#else
+        void *window = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, (off_t)offset);
+        if (window == MAP_FAILED)
+        {
+            failed = true;
+            return false;
+        }
+        madvise(window, length, MADV_SEQUENTIAL);
+        mapped = (char *)window;
+        mappedLength = length;
+        cursor = mapped;
+#endif
+        end = cursor + length;
+        offset += length;
+        return true;
+    }
+
+public:
+    PageTraceReader()
+        : fileSize(0), offset(0), cursor(nullptr), end(nullptr), binary(false), failed(false), value(0), negative(false), inNumber(false)
+    {
+#ifndef _WIN32
+        fd = -1;
+        mapped = nullptr;
+        mappedLength = 0;
+#endif
+    }
+
+    ~PageTraceReader() { close(); }
+
+    bool open(const string &path)
+    {
+        close();
+        failed = false;
+        offset = 0;
+        value = 0;
+        negative = inNumber = false;
+#ifdef _WIN32
+        file.open(path.c_str(), ios::binary);
+        if (!file)
+            return false;
+        file.seekg(0, ios::end);
+        fileSize = (size_t)file.tellg();
+        file.seekg(0);
+#else
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0)
+        {
+            close();
+            return false;
+        }
+        fileSize = (size_t)info.st_size;
+#endif
+        if (!loadWindow())
+            return fileSize == 0;
+        binary = (size_t)(end - cursor) >= sizeof(PAGE_TRACE_MAGIC) && memcmp(cursor, PAGE_TRACE_MAGIC, sizeof(PAGE_TRACE_MAGIC)) == 0;
+        if (binary)
+            cursor += sizeof(PAGE_TRACE_MAGIC);
+        return true;
+    }
+
+    void close()
+    {
+        releaseWindow();
+#ifdef _WIN32
+        if (file.is_open())
+            file.close();
+#else
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+#endif
+        fileSize = 0;
+    }
+
+    bool isBinary() const { return binary; }
+    bool hasFailed() const { return failed; }
+
+    // Fill out with up to max references; returns 0 at the end of the trace
+    size_t next(int *out, size_t max)
+    {
+        size_t count = 0;
+        while (count < max)
+        {
+            if (cursor == end && !loadWindow())
+            {
+                if (!binary && negative && !inNumber && !failed)
+                    reject(); // A trailing lone '-'
+                else if (!binary && inNumber && !failed)
+                {
+                    if (!negative && value > INT_MAX)
+                    {
+                        reject();
+                        break;
+                    }
+                    out[count++] = (int)(negative ? -value : value);
+                    inNumber = false;
+                }
+                break;
+            }
+            if (binary)
+            {
+                // Windows start on page boundaries and records on 4-byte ones, so none straddle
+                size_t available = min((size_t)(end - cursor) / sizeof(int32_t), max - count);
+                memcpy(out + count, cursor, available * sizeof(int32_t));
+                cursor += available * sizeof(int32_t);
+                count += available;
+                if ((size_t)(end - cursor) < sizeof(int32_t))
+                    cursor = end;
+                continue;
+            }
+            const char *p = cursor;
+            while (p != end && count < max)
+            {
+                unsigned digit = (unsigned)(*p - '0');
+                if (digit < 10)
+                {
+                    value = value * 10 + digit;
+                    inNumber = true;
+                    if (value > (long long)INT_MAX + 1)
+                    {
+                        reject();
+                        return count;
+                    }
+                }
+                else if (*p == '-' && !inNumber && !negative)
+                    negative = true; // Sign at the start of a token
+                else if (*p == ' ' || *p == '\n' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f')
+                {
+                    if (negative && !inNumber)
+                    {
+                        reject();
+                        return count;
+                    }
+                    if (inNumber)
+                    {
+                        if (!negative && value > INT_MAX)
+                        {
+                            reject();
+                            return count;
+                        }
+                        out[count++] = (int)(negative ? -value : value);
+                        value = 0;
+                        inNumber = false;
+                    }
+                    negative = false;
+                }
+                else
+                {
+                    reject();
+                    return count;
+                }
+                p++;
+            }
+            cursor = p;
+        }
+        return count;
+    }
+};
+
+// Read a whole trace into memory (needed by policies that look ahead)
+bool loadPageTrace(const string &path, vector<int> &pageReferences)
+{
+    PageTraceReader reader;
+    if (!reader.open(path))
+        return false;
+    pageReferences.clear();
+    const size_t CHUNK = 1 << 16;
+    size_t count;
+    do
+    {
+        size_t used = pageReferences.size();
+        pageReferences.resize(used + CHUNK);
+        count = reader.next(pageReferences.data() + used, CHUNK);
+        pageReferences.resize(used + count);
+    } while (count > 0);
+    return !reader.hasFailed();
+}
+
+// Write references as a binary page trace
+bool writePageTrace(const string &path, const vector<int> &pageReferences)
+{
+    ofstream out(path.c_str(), ios::binary | ios::trunc);
+    if (!out)
+        return false;
+    out.write(PAGE_TRACE_MAGIC, sizeof(PAGE_TRACE_MAGIC));
+    out.write((const char *)pageReferences.data(), pageReferences.size() * sizeof(int));
+    return (bool)out;
+}
+
+// Stream a trace file through one replacement algorithm in fixed-size chunks.
+// Optimal needs the whole trace for its next-use index, so it loads it first.
+bool runReplacementTrace(ReplacementAlgorithm algorithm, int numFrames, const string &path, ReplacementResult &result, TraceWriter *trace = nullptr)
+{
+    result = ReplacementResult();
+    if (algorithm == REPLACEMENT_OPTIMAL)
+    {
+        vector<int> pageReferences;
+        if (!loadPageTrace(path, pageReferences))
+            return false;
+        result = runReplacement(algorithm, numFrames, pageReferences, false, trace);
+        return true;
+    }
+
+    PageTraceReader reader;
+    if (!reader.open(path))
+        return false;
+    ScopedTimer timer(TIMER_REPLACEMENT);
+    unique_ptr<ReplacementPolicy> policy(makeReplacementPolicy(algorithm, numFrames, vector<int>()));
+    vector<int> chunk(1 << 16);
+    long long base = 0;
+    size_t count;
+    while ((count = reader.next(chunk.data(), chunk.size())) > 0)
+    {
+        replayReferences(*policy, chunk.data(), count, base, result, false, trace);
+        base += count;
+    }
+    result.frames = policy->residentPages();
+    return !reader.hasFailed();
+}
+
+struct MissRatioPoint
+{
+    int frames;
+    long long faults;
+    double faultRate;
+};
+
+// LRU stack-distance analysis (Mattson et al.). A Fenwick tree over access
+// positions marks the latest access of every page, so the distance of a
+// reference is the number of marks since its page was last touched. One pass
+// yields the LRU fault count for every frame count. With a sampling rate
+// below 1, only pages whose hash falls under the rate are tracked and their
+// distances are scaled up (SHARDS), trading exactness for memory and time.
+class StackDistanceAnalyzer
+{
+private:
+    int maxFrames;
+    double rate;
+    uint64_t threshold;
+    vector<int> tree;     // Fenwick tree over positions
+    vector<int> pageAt;   // Page whose latest access sits at each position
+    vector<char> live;
+    PageSlotMap positionOf;
+    int now;
+    vector<long long> histogram; // histogram[d] for distances 1..maxFrames
+    long long beyond;            // Cold misses and distances above maxFrames
+    long long sampled;
+    long long total;
+
+    static uint64_t hashPage(int page)
+    {
+        uint64_t z = (uint64_t)(uint32_t)page + 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    void add(int i, int delta)
+    {
+        for (i++; i <= (int)tree.size(); i += i & -i)
+            tree[i - 1] += delta;
+    }
+
+    // Number of marks at positions [0, i)
+    int prefix(int i) const
+    {
+        int sum = 0;
+        for (; i > 0; i -= i & -i)
+            sum += tree[i - 1];
+        return sum;
+    }
+
+    // Renumber live positions densely once the position space is used up
+    void compact()
+    {
+        int liveCount = 0;
+        for (int i = 0; i < now; i++)
+            liveCount += live[i];
+        size_t capacity = tree.size();
+        if (liveCount * 2 > (int)capacity)
+            capacity *= 2;
+        vector<int> pages;
+        pages.reserve(liveCount);
+        for (int i = 0; i < now; i++)
+            if (live[i])
+                pages.push_back(pageAt[i]);
+
+        tree.assign(capacity, 0);
+        pageAt.assign(capacity, 0);
+        live.assign(capacity, 0);
+        for (int i = 0; i < liveCount; i++)
+        {
+            pageAt[i] = pages[i];
+            live[i] = 1;
+            positionOf.set(pages[i], i);
+            tree[i] = 1;
+        }
+        // Linear-time Fenwick build
+        for (int i = 1; i <= (int)capacity; i++)
+        {
+            int parent = i + (i & -i);
+            if (parent <= (int)capacity)
+                tree[parent - 1] += tree[i - 1];
+        }
+        now = liveCount;
+    }
+
+public:
+    StackDistanceAnalyzer(int maxFrameCount, double samplingRate = 1.0)
+        : maxFrames(maxFrameCount), rate(samplingRate), tree(1 << 16, 0), pageAt(1 << 16, 0), live(1 << 16, 0),
+          now(0), histogram(maxFrameCount + 1, 0), beyond(0), sampled(0), total(0)
+    {
+        if (rate <= 0 || rate > 1)
+            rate = 1.0;
+        threshold = rate >= 1.0 ? UINT64_MAX : (uint64_t)(rate * 18446744073709551616.0);
+    }
+
+    void access(int page)
+    {
+        total++;
+        if (rate < 1.0 && hashPage(page) >= threshold)
+            return;
+        sampled++;
+        if (now == (int)tree.size())
+            compact();
+
+        int last = positionOf.find(page);
+        if (last < 0)
+            beyond++;
+        else
+        {
+            long long distance = prefix(now) - prefix(last + 1) + 1;
+            if (rate < 1.0)
+                distance = (long long)(distance / rate);
+            if (distance <= maxFrames)
+                histogram[distance]++;
+            else
+                beyond++;
+            add(last, -1);
+            live[last] = 0;
+        }
+        add(now, 1);
+        live[now] = 1;
+        pageAt[now] = page;
+        positionOf.set(page, now);
+        now++;
+    }
+
+    long long references() const { return total; }
+
+    // Fault count and rate for every frame count from 1 to maxFrames
+    vector<MissRatioPoint> curve() const
+    {
+        vector<MissRatioPoint> points(maxFrames);
+        long long misses = beyond;
+        for (int frames = maxFrames; frames >= 1; frames--)
+        {
+            double faultRate = sampled ? (double)misses / sampled : 0.0;
+            points[frames - 1].frames = frames;
+            points[frames - 1].faultRate = faultRate;
+            points[frames - 1].faults = rate < 1.0 ? (long long)(faultRate * total + 0.5) : misses;
+            misses += histogram[frames];
+        }
+        return points;
+    }
+};
+
+// Write a miss-ratio curve as frames,faults,fault_rate rows
+bool writeMissRatioCSV(const vector<MissRatioPoint> &points, const string &path)
+{
+    ofstream out(path.c_str());
+    if (!out)
+        return false;
+    out << "frames,faults,fault_rate\n";
+    for (size_t i = 0; i < points.size(); i++)
+        out << points[i].frames << ',' << points[i].faults << ',' << points[i].faultRate << '\n';
+    return (bool)out;
+}
+
+// Counters of the virtual memory model
+struct VmStats
+{
+    long long accesses;
+    long long tlbHits;
+    long long tlbMisses;
+    long long pageFaults;
+    long long evictions;
+    long long invalid; // Accesses outside the process's address space
+
+    VmStats() : accesses(0), tlbHits(0), tlbMisses(0), pageFaults(0), evictions(0), invalid(0) {}
+    double tlbHitRate() const { return accesses ? (double)tlbHits / accesses : 0.0; }
+    double faultRate() const { return accesses ? (double)pageFaults / accesses : 0.0; }
+};
+
+// Index of the lowest clear bit of a word that has one
+inline int lowestClearBit(uint64_t word)
+{
+#ifdef __GNUC__
+    return __builtin_ctzll(~word);
+#else
+    int bit = 0;
+    while (word & 1)
+    {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+// Physical frame pool tracked by a free-frame bitmap (set bit = in use).
+// Allocation scans words from where the last one succeeded.
+class FrameAllocator
+{
+private:
+    vector<uint64_t> words;
+    int total;
+    int freeCount;
+    size_t cursor;
+
+public:
+    explicit FrameAllocator(int frames = 0) { reset(frames); }
+
+    void reset(int frames)
+    {
+        total = max(0, frames);
+        freeCount = total;
+        words.assign((total + 63) / 64, 0);
+        if (total % 64)
+            words.back() = ~0ULL << (total % 64); // Bits past the last frame stay set
+        cursor = 0;
+    }
+
+    // Lowest free frame at or after the cursor, or -1 if memory is full
+    int allocate()
+    {
+        if (freeCount == 0)
+            return -1;
+        for (size_t n = 0; n < words.size(); n++, cursor = cursor + 1 == words.size() ? 0 : cursor + 1)
+            if (~words[cursor])
+            {
+                int bit = lowestClearBit(words[cursor]);
+                words[cursor] |= 1ULL << bit;
+                freeCount--;
+                return (int)(cursor * 64 + bit);
+            }
+        return -1;
+    }
+
+    void release(int frame)
+    {
+        words[frame / 64] &= ~(1ULL << (frame % 64));
+        freeCount++;
+    }
+
+    // Take a specific frame; false if it is out of range or already in use
+    bool claim(int frame)
+    {
+        if (frame < 0 || frame >= total || (words[frame / 64] >> (frame % 64) & 1))
+            return false;
+        words[frame / 64] |= 1ULL << (frame % 64);
+        freeCount--;
+        return true;
+    }
+
+    int frames() const { return total; }
+    int freeFrames() const { return freeCount; }
+};
+
+// Radix page table: every level resolves LEVEL_BITS of the virtual page
+// number, so only the tables covering mapped regions are allocated. Tables
+// are blocks of one flat array; interior entries hold the block of the next
+// level and leaf entries hold frame + 1 (0 = not present).
+class PageTable
+{
+private:
+    static const int LEVEL_BITS = 10;
+    static const uint32_t FANOUT = 1u << LEVEL_BITS;
+    vector<uint32_t> entries; // Block 0 is the root
+    int levels;
+
+public:
+    explicit PageTable(int vpnBits) : entries(FANOUT, 0), levels(max(1, (vpnBits + LEVEL_BITS - 1) / LEVEL_BITS)) {}
+
+    // Leaf entry for vpn without allocating
+    uint32_t lookup(uint64_t vpn) const
+    {
+        uint32_t block = 0;
+        for (int level = levels - 1; level > 0; level--)
+        {
+            block = entries[block * FANOUT + ((vpn >> (level * LEVEL_BITS)) & (FANOUT - 1))];
+            if (!block)
+                return 0;
+        }
+        return entries[block * FANOUT + (vpn & (FANOUT - 1))];
+    }
+
+    // Set the leaf entry for vpn, creating intermediate tables as needed
+    void store(uint64_t vpn, uint32_t entry)
+    {
+        uint32_t block = 0;
+        for (int level = levels - 1; level > 0; level--)
+        {
+            size_t i = block * FANOUT + ((vpn >> (level * LEVEL_BITS)) & (FANOUT - 1));
+            if (!entries[i])
+            {
+                uint32_t created = (uint32_t)(entries.size() / FANOUT);
+                entries.resize(entries.size() + FANOUT, 0);
+                entries[i] = created;
+            }
+            block = entries[i];
+        }
+        entries[block * FANOUT + (vpn & (FANOUT - 1))] = entry;
+    }
+
+    // Call visit(vpn, frame) for every present page
+    template <typename Visit>
+    void forEachMapping(Visit visit, uint32_t block = 0, int level = -1, uint64_t prefix = 0) const
+    {
+        if (level < 0)
+            level = levels - 1;
+        for (uint32_t i = 0; i < FANOUT; i++)
+        {
+            uint32_t entry = entries[block * FANOUT + i];
+            if (!entry)
+                continue;
+            if (level == 0)
+                visit((prefix << LEVEL_BITS) | i, (int)entry - 1);
+            else
+                forEachMapping(visit, entry, level - 1, (prefix << LEVEL_BITS) | i);
+        }
+    }
+
+    int depth() const { return levels; }
+    size_t tables() const { return entries.size() / FANOUT; }
+};
+
+// Set-associative TLB with LRU replacement inside each set. Tags combine the
+// address-space ID with the virtual page, so switching processes needs no flush.
+class Tlb
+{
+private:
+    static const uint64_t EMPTY = ~0ULL;
+    vector<uint64_t> tags;
+    vector<int32_t> frames;
+    vector<uint32_t> lastUse;
+    size_t setMask;
+    int ways;
+    uint32_t clock;
+
+    size_t setOf(uint64_t tag) const { return (size_t)((tag ^ (tag >> 40) * 0x9E3779B1u) & setMask); }
+
+public:
+    Tlb() { configure(16, 4); }
+
+    // sets is rounded down to a power of two
+    void configure(int sets, int associativity)
+    {
+        size_t count = 1;
+        while (count * 2 <= (size_t)max(1, sets))
+            count *= 2;
+        setMask = count - 1;
+        ways = max(1, associativity);
+        tags.assign(count * ways, EMPTY);
+        frames.assign(count * ways, -1);
+        lastUse.assign(count * ways, 0);
+        clock = 0;
+    }
+
+    int lookup(uint64_t tag)
+    {
+        size_t base = setOf(tag) * ways;
+        for (int w = 0; w < ways; w++)
+            if (tags[base + w] == tag)
+            {
+                lastUse[base + w] = ++clock;
+                return frames[base + w];
+            }
+        return -1;
+    }
+
+    void insert(uint64_t tag, int frame)
+    {
+        size_t base = setOf(tag) * ways, victim = base;
+        for (int w = 0; w < ways; w++)
+        {
+            if (tags[base + w] == EMPTY)
+            {
+                victim = base + w;
+                break;
+            }
+            if (lastUse[base + w] < lastUse[victim])
+                victim = base + w;
+        }
+        tags[victim] = tag;
+        frames[victim] = frame;
+        lastUse[victim] = ++clock;
+    }
+
+    void invalidate(uint64_t tag)
+    {
+        size_t base = setOf(tag) * ways;
+        for (int w = 0; w < ways; w++)
+            if (tags[base + w] == tag)
+                tags[base + w] = EMPTY;
+    }
+
+    void flush() { fill(tags.begin(), tags.end(), EMPTY); }
+
+    // Call visit(tag, frame, lastUse) for every slot in index order; empty slots have tag EMPTY
+    template <typename Visit>
+    void forEachSlot(Visit visit) const
+    {
+        for (size_t i = 0; i < tags.size(); i++)
+            visit(tags[i], frames[i], lastUse[i]);
+    }
+
+    void restoreSlot(size_t i, uint64_t tag, int frame, uint32_t used)
+    {
+        tags[i] = tag;
+        frames[i] = frame;
+        lastUse[i] = used;
+    }
+
+    uint32_t useClock() const { return clock; }
+    void restoreUseClock(uint32_t used) { clock = used; }
+    size_t slots() const { return tags.size(); }
+    static bool emptyTag(uint64_t tag) { return tag == EMPTY; }
+    size_t sets() const { return setMask + 1; }
+    int associativity() const { return ways; }
+};
+
+const uint64_t Tlb::EMPTY;
+
+// Virtual memory model: per-process radix page tables over a shared physical
+// frame pool, a TLB in front of them, and Clock replacement across all frames
+// when the pool runs out. Address spaces are keyed by PID (PIDs below 2^24).
+class VirtualMemory
+{
+public:
+    struct AddressSpace
+    {
+        int pid;
+        uint64_t pageLimit; // Pages in the space
+        PageTable table;
+
+        AddressSpace(int id, uint64_t pages, int vpnBits) : pid(id), pageLimit(pages), table(vpnBits) {}
+    };
+
+private:
+    struct FrameOwner
+    {
+        AddressSpace *space;
+        uint64_t vpn;
+    };
+
+    int pageShift;
+    int addressBits;
+    FrameAllocator frames;
+    vector<FrameOwner> owners;
+    vector<uint8_t> referenced;
+    size_t hand; // Clock hand over frames
+    Tlb tlb;
+    unordered_map<int, unique_ptr<AddressSpace>> spaces;
+    VmStats stats;
+
+    static uint64_t tagOf(const AddressSpace &space, uint64_t vpn) { return ((uint64_t)space.pid << 40) | vpn; }
+
+    // Take a frame from its owner (Clock: skip recently referenced frames)
+    int evict()
+    {
+        while (referenced[hand])
+        {
+            referenced[hand] = 0;
+            hand = hand + 1 == owners.size() ? 0 : hand + 1;
+        }
+        int victim = (int)hand;
+        hand = hand + 1 == owners.size() ? 0 : hand + 1;
+        FrameOwner &owner = owners[victim];
+        owner.space->table.store(owner.vpn, 0);
+        tlb.invalidate(tagOf(*owner.space, owner.vpn));
+        stats.evictions++;
+        return victim;
+    }
+
+public:
+    VirtualMemory() : pageShift(8), addressBits(32), hand(0) { configure(1024, 256, 16, 4, 32); }
+
+    // Reset the model: frameCount frames of pageSize bytes (a power of two),
+    // a tlbSets x tlbWays TLB and virtual addresses of addressBits bits.
+    // Existing address spaces are dropped.
+    bool configure(int frameCount, int pageSize, int tlbSets, int tlbWays, int bits)
+    {
+        int shift = 0;
+        while ((1 << shift) < pageSize && shift < 30)
+            shift++;
+        if (frameCount <= 0 || pageSize <= 0 || (1 << shift) != pageSize || tlbSets <= 0 || tlbWays <= 0 || bits <= shift || bits - shift > 40 || bits > 48)
+            return false;
+        pageShift = shift;
+        addressBits = bits;
+        frames.reset(frameCount);
+        owners.assign(frameCount, FrameOwner{nullptr, 0});
+        referenced.assign(frameCount, 0);
+        hand = 0;
+        tlb.configure(tlbSets, tlbWays);
+        spaces.clear();
+        stats = VmStats();
+        return true;
+    }
+
+    // Create (or replace) the address space of pid with sizeBytes of virtual memory (0 = the whole range)
+    AddressSpace *createSpace(int pid, uint64_t sizeBytes)
+    {
+        if (pid <= 0 || pid >= (1 << 24))
+            return nullptr;
+        destroySpace(pid);
+        uint64_t maxPages = 1ULL << (addressBits - pageShift);
+        uint64_t pages = sizeBytes ? min(maxPages, (sizeBytes + pageSize() - 1) >> pageShift) : maxPages;
+        unique_ptr<AddressSpace> &slot = spaces[pid];
+        slot.reset(new AddressSpace(pid, pages, addressBits - pageShift));
+        return slot.get();
+    }
+
+    AddressSpace *space(int pid)
+    {
+        unordered_map<int, unique_ptr<AddressSpace>>::iterator it = spaces.find(pid);
+        return it == spaces.end() ? nullptr : it->second.get();
+    }
+
+    // Free the frames and TLB entries of pid's address space
+    void destroySpace(int pid)
+    {
+        AddressSpace *target = space(pid);
+        if (!target)
+            return;
+        target->table.forEachMapping([this, target](uint64_t vpn, int frame) {
+            frames.release(frame);
+            owners[frame].space = nullptr;
+            referenced[frame] = 0;
+            tlb.invalidate(tagOf(*target, vpn));
+        });
+        spaces.erase(pid);
+    }
+
+    void clearSpaces()
+    {
+        spaces.clear();
+        frames.reset(frames.frames());
+        owners.assign(owners.size(), FrameOwner{nullptr, 0});
+        referenced.assign(referenced.size(), 0);
+        hand = 0;
+        tlb.flush();
+    }
+
+    // Physical address of vaddr, faulting the page in on first touch;
+    // -1 if the address is outside the space
+    long long translate(AddressSpace &space, uint64_t vaddr)
+    {
+        uint64_t vpn = vaddr >> pageShift;
+        stats.accesses++;
+        if (vpn >= space.pageLimit)
+        {
+            stats.invalid++;
+            return -1;
+        }
+        uint64_t tag = tagOf(space, vpn);
+        int frame = tlb.lookup(tag);
+        if (frame >= 0)
+            stats.tlbHits++;
+        else
+        {
+            stats.tlbMisses++;
+            uint32_t entry = space.table.lookup(vpn);
+            if (entry)
+                frame = (int)entry - 1;
+            else
+            {
+                stats.pageFaults++;
+                frame = frames.allocate();
+                if (frame < 0)
+                    frame = evict();
+                space.table.store(vpn, (uint32_t)frame + 1);
+                owners[frame] = FrameOwner{&space, vpn};
+            }
+            tlb.insert(tag, frame);
+        }
+        referenced[frame] = 1;
+        return ((long long)frame << pageShift) | (long long)(vaddr & (pageSize() - 1));
+    }
+
+    // Call visit(space) for every address space, in no particular order
+    template <typename Visit>
+    void forEachSpace(Visit visit) const
+    {
+        for (unordered_map<int, unique_ptr<AddressSpace>>::const_iterator it = spaces.begin(); it != spaces.end(); ++it)
+            visit(*it->second);
+    }
+
+    // Install a mapping saved earlier; false if the page or frame is invalid or the frame is taken
+    bool restoreMapping(AddressSpace &space, uint64_t vpn, int frame)
+    {
+        if (vpn >= space.pageLimit || space.table.lookup(vpn) || !frames.claim(frame))
+            return false;
+        space.table.store(vpn, (uint32_t)frame + 1);
+        owners[frame] = FrameOwner{&space, vpn};
+        return true;
+    }
+
+    // Clock replacement state: the hand and one referenced flag per frame
+    size_t clockHand() const { return hand; }
+    const vector<uint8_t> &referenceBits() const { return referenced; }
+
+    void restoreClock(size_t clockHand, const uint8_t *bits)
+    {
+        hand = clockHand < referenced.size() ? clockHand : 0;
+        for (size_t frame = 0; frame < referenced.size(); frame++)
+            referenced[frame] = bits[frame] ? 1 : 0;
+    }
+
+    const Tlb &tlbState() const { return tlb; }
+
+    // Put back one saved TLB slot; a filled slot must agree with the page tables
+    bool restoreTlbSlot(size_t slot, uint64_t tag, int frame, uint32_t lastUse)
+    {
+        if (slot >= tlb.slots())
+            return false;
+        if (!Tlb::emptyTag(tag))
+        {
+            AddressSpace *owner = space((int)(tag >> 40));
+            uint64_t vpn = tag & ((1ULL << 40) - 1);
+            if (!owner || vpn >= owner->pageLimit || owner->table.lookup(vpn) != (uint32_t)frame + 1)
+                return false;
+        }
+        tlb.restoreSlot(slot, tag, frame, lastUse);
+        return true;
+    }
+
+    void restoreTlbClock(uint32_t lastUse) { tlb.restoreUseClock(lastUse); }
+
+    const VmStats &counters() const { return stats; }
+    void resetCounters() { stats = VmStats(); }
+    void restoreCounters(const VmStats &saved) { stats = saved; }
+    int pageSize() const { return 1 << pageShift; }
+    int frameCount() const { return frames.frames(); }
+    int freeFrames() const { return frames.freeFrames(); }
+    size_t tlbSets() const { return tlb.sets(); }
+    int tlbWays() const { return tlb.associativity(); }
+    int virtualAddressBits() const { return addressBits; }
+};
+
+enum ArrivalPattern
+{
+    ARRIVAL_UNIFORM, // Uniform over [0, span)
+    ARRIVAL_POISSON, // Exponential inter-arrival gaps at a given rate
+    ARRIVAL_COUNT
+};
+
+enum BurstDistribution
+{
+    BURST_UNIFORM,     // Uniform over [1, 2 * mean)
+    BURST_EXPONENTIAL,
+    BURST_PARETO,      // Heavy tail; shape is alpha (> 1)
+    BURST_LOGNORMAL,   // Heavy tail; shape is sigma of the underlying normal
+    BURST_BIMODAL,     // Short interactive jobs mixed with long batch jobs
+    BURST_COUNT
+};
+
+const char *arrivalName(ArrivalPattern pattern)
+{
+    static const char *names[ARRIVAL_COUNT] = {"uniform", "poisson"};
+    return names[pattern];
+}
+
+const char *burstName(BurstDistribution distribution)
+{
+    static const char *names[BURST_COUNT] = {"uniform", "exponential", "pareto", "lognormal", "bimodal"};
+    return names[distribution];
+}
+
+// Shape of a synthetic process workload. The defaults match the old
+// rand()-based generator: arrivals and bursts below 100, priorities 0-9.
+struct WorkloadSpec
+{
+    ArrivalPattern arrivals;
+    int arrivalSpan;        // Uniform arrivals fall in [0, arrivalSpan)
+    double arrivalRate;     // Poisson arrivals per tick
+    BurstDistribution bursts;
+    double meanBurst;
+    double shape;           // Pareto alpha or lognormal sigma
+    int maxBurst;           // Bursts are clamped to [1, maxBurst]
+    double interactiveShare; // Bimodal: fraction of interactive jobs
+    double interactiveBurst; // Bimodal: mean burst of interactive jobs
+    int priorities;          // Priorities are drawn from [0, priorities)
+    double slack;            // Deadline = AT + ceil(slack * burst); 0 = no deadlines
+
+    WorkloadSpec()
+        : arrivals(ARRIVAL_UNIFORM), arrivalSpan(100), arrivalRate(1.0), bursts(BURST_UNIFORM), meanBurst(50), shape(1.5),
+          maxBurst(1000000), interactiveShare(0.8), interactiveBurst(5), priorities(10), slack(2.0) {}
+};
+
+// Shape of a synthetic page reference string (working-set model). References
+// stay inside a window of workingSet pages with probability locality and fall
+// anywhere in the address space otherwise; after each phase, whose length is
+// exponential around phaseLength, the window moves to a random place.
+struct LocalitySpec
+{
+    int pages;        // Address space size in pages
+    int workingSet;
+    int phaseLength;
+    double locality;
+
+    LocalitySpec() : pages(1024), workingSet(32), phaseLength(10000), locality(0.9) {}
+};
+
+// Reproducible workload source; the whole output is a function of the seed
+class WorkloadGenerator
+{
+private:
+    Xoshiro256 rng;
+    double clock; // Poisson arrival clock, carried across generate() calls
+
+    int clampBurst(double burst, const WorkloadSpec &spec)
+    {
+        if (!(burst < spec.maxBurst))
+            return spec.maxBurst;
+        return burst < 1 ? 1 : (int)burst;
+    }
+
+public:
+    explicit WorkloadGenerator(uint64_t seed = 1) : rng(seed), clock(0) {}
+
+    void seed(uint64_t seed)
+    {
+        rng.seed(seed);
+        clock = 0;
+    }
+
+    Xoshiro256 &engine() { return rng; }
+    const Xoshiro256 &engine() const { return rng; }
+    double arrivalClock() const { return clock; }
+
+    // Resume from a saved engine state and Poisson arrival clock
+    void restore(const uint64_t *state, double arrivalClock)
+    {
+        rng.restore(state);
+        clock = arrivalClock;
+    }
+
+    // Fill jobs[0..count) with processes numbered from firstPid
+    void generate(const WorkloadSpec &spec, SimJob *jobs, size_t count, int firstPid)
+    {
+        int priorities = max(spec.priorities, 1);
+        int half = (priorities + 1) / 2;
+        double mean = max(spec.meanBurst, 1.0);
+        for (size_t i = 0; i < count; i++)
+        {
+            SimJob &job = jobs[i];
+            job.pid = firstPid + (int)i;
+            if (spec.arrivals == ARRIVAL_POISSON)
+            {
+                clock += rng.exponential(1.0 / spec.arrivalRate);
+                job.AT = clock < INT_MAX ? (int)clock : INT_MAX;
+            }
+            else
+                job.AT = (int)rng.below((uint32_t)max(spec.arrivalSpan, 1));
+
+            switch (spec.bursts)
+            {
+            case BURST_UNIFORM:
+                job.burst = clampBurst(1 + rng.uniform() * (2 * mean - 1), spec);
+                break;
+            case BURST_EXPONENTIAL:
+                job.burst = clampBurst(rng.exponential(mean), spec);
+                break;
+            case BURST_PARETO:
+            {
+                // Scale chosen so the mean is meanBurst when alpha > 1
+                double alpha = max(spec.shape, 1.01);
+                double scale = mean * (alpha - 1) / alpha;
+                job.burst = clampBurst(scale / pow(1.0 - rng.uniform(), 1.0 / alpha), spec);
+                break;
+            }
+            case BURST_LOGNORMAL:
+            {
+                double sigma = spec.shape;
+                job.burst = clampBurst(exp(log(mean) - sigma * sigma / 2 + sigma * rng.normal()), spec);
+                break;
+            }
+            default:
+                // Interactive jobs are short and take the upper (favoured)
+                // half of the priorities; batch jobs the lower half
+                if (rng.uniform() < spec.interactiveShare)
+                {
+                    job.burst = clampBurst(rng.exponential(spec.interactiveBurst), spec);
+                    job.priority = priorities - half + (int)rng.below((uint32_t)half);
+                }
+                else
+                {
+                    job.burst = clampBurst(rng.exponential(mean), spec);
+                    job.priority = (int)rng.below((uint32_t)max(priorities - half, 1));
+                }
+                break;
+            }
+            if (spec.bursts != BURST_BIMODAL)
+                job.priority = (int)rng.below((uint32_t)priorities);
+            job.remainingBT = job.burst;
+            job.firstRun = job.completion = -1;
+            job.cpu = -1;
+            // Derived rather than drawn, so a seed gives the same jobs at any slack
+            job.deadline = spec.slack > 0 ? (int)min(job.AT + ceil(spec.slack * job.burst), (double)INT_MAX) : -1;
+        }
+    }
+
+    vector<SimJob> generate(const WorkloadSpec &spec, int count, int firstPid = 1)
+    {
+        vector<SimJob> jobs(max(count, 0));
+        generate(spec, jobs.data(), jobs.size(), firstPid);
+        return jobs;
+    }
+
+    // Append count page references following spec
+    void pageReferences(const LocalitySpec &spec, size_t count, vector<int> &references)
+    {
+        uint32_t pages = (uint32_t)max(spec.pages, 1);
+        uint32_t window = (uint32_t)min(max(spec.workingSet, 1), (int)pages);
+        uint32_t base = rng.below(pages - window + 1);
+        size_t phaseLeft = 1 + (size_t)rng.exponential(max(spec.phaseLength, 1));
+        references.reserve(references.size() + count);
+        for (size_t i = 0; i < count; i++)
+        {
+            if (--phaseLeft == 0)
+            {
+                base = rng.below(pages - window + 1);
+                phaseLeft = 1 + (size_t)rng.exponential(max(spec.phaseLength, 1));
+            }
+            if (rng.uniform() < spec.locality)
+                references.push_back((int)(base + rng.below(window)));
+            else
+                references.push_back((int)rng.below(pages));
+        }
+    }
+};
+
+// Fixed set of tasks run on worker threads that each own a deque: a worker
+// takes from the back of its own deque and, once that is empty, steals from
+// the front of the others'. Tasks receive the index of the worker running them.
+class WorkStealingPool
+{
+private:
+    struct Worker
+    {
+        mutex lock;
+        deque<function<void(unsigned)>> tasks;
+    };
+
+    vector<unique_ptr<Worker>> workers;
+
+    bool take(unsigned self, function<void(unsigned)> &task)
+    {
+        {
+            lock_guard<mutex> guard(workers[self]->lock);
+            if (!workers[self]->tasks.empty())
+            {
+                task = move(workers[self]->tasks.back());
+                workers[self]->tasks.pop_back();
+                return true;
+            }
+        }
+        for (size_t i = 1; i < workers.size(); i++)
+        {
+            Worker &victim = *workers[(self + i) % workers.size()];
+            lock_guard<mutex> guard(victim.lock);
+            if (!victim.tasks.empty())
+            {
+                task = move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void work(unsigned self)
+    {
+        function<void(unsigned)> task;
+        while (take(self, task))
+            task(self);
+    }
+
+public:
+    explicit WorkStealingPool(unsigned threads)
+    {
+        if (threads == 0)
+            threads = 1;
+        for (unsigned i = 0; i < threads; i++)
+            workers.emplace_back(new Worker());
+    }
+
+    unsigned size() const { return (unsigned)workers.size(); }
+
+    // Run every task and return once all have finished. No task may add more.
+    void run(vector<function<void(unsigned)>> &tasks)
+    {
+        for (size_t i = 0; i < tasks.size(); i++)
+            workers[i % workers.size()]->tasks.push_back(move(tasks[i]));
+        tasks.clear();
+        vector<thread> threads;
+        for (unsigned i = 1; i < workers.size(); i++)
+            threads.emplace_back(&WorkStealingPool::work, this, i);
+        work(0);
+        for (size_t i = 0; i < threads.size(); i++)
+            threads[i].join();
+    }
+};
+
+// Parameter grid for a sweep. Every (policy, quantum, replicate) combination
+// is one scheduling job and every (algorithm, frames) pair one replacement job.
+struct SweepGrid
+{
+    vector<SchedulingPolicy> policies;
+    vector<int> quanta;             // Round-Robin / Multilevel quanta, 0 = adaptive (defaults to 10)
+    int replicates;                 // Independent workloads per scheduling configuration
+    int randomProcesses;            // Processes per generated workload (0 = use the given workload)
+    WorkloadSpec workload;          // Shape of generated workloads
+    unsigned seed;
+    vector<ReplacementAlgorithm> algorithms;
+    vector<int> frameCounts;
+    unsigned threads;
+
+    SweepGrid() : replicates(1), randomProcesses(0), seed(1), threads(thread::hardware_concurrency()) {}
+};
+
+// One merged row of sweep output
+struct SweepRow
+{
+    bool scheduling;
+    int policy;  // SchedulingPolicy or ReplacementAlgorithm
+    int quantum; // Scheduling: time quantum; replacement: frame count
+    int replicate;
+    SimulationResult simulation;
+    ReplacementResult replacement;
+    bool failed; // Replacement: the trace could not be read
+
+    SweepRow() : scheduling(false), policy(0), quantum(0), replicate(0), simulation(), failed(false) {}
+};
+
+// Run every configuration of a grid in parallel. Scheduling jobs use the given
+// workload, or generate their own from a per-worker RNG reseeded from
+// (seed, replicate) so results do not depend on thread timing. Replacement
+// jobs read the shared reference string, or stream tracePath when it is set.
+vector<SweepRow> runSweep(const SweepGrid &grid, const vector<SimJob> &workload, const vector<int> &pageReferences, const string &tracePath)
+{
+    vector<int> quanta = grid.quanta.empty() ? vector<int>(1, 10) : grid.quanta;
+    vector<SweepRow> rows;
+    for (size_t p = 0; p < grid.policies.size(); p++)
+        for (size_t q = 0; q < quanta.size(); q++)
+            for (int r = 0; r < grid.replicates; r++)
+            {
+                SweepRow row;
+                row.scheduling = true;
+                row.policy = grid.policies[p];
+                row.quantum = quanta[q];
+                row.replicate = r;
+                rows.push_back(row);
+            }
+    for (size_t a = 0; a < grid.algorithms.size(); a++)
+        for (size_t f = 0; f < grid.frameCounts.size(); f++)
+        {
+            SweepRow row;
+            row.scheduling = false;
+            row.policy = grid.algorithms[a];
+            row.quantum = grid.frameCounts[f];
+            row.replicate = 0;
+            rows.push_back(row);
+        }
+
+    WorkStealingPool pool(grid.threads);
+    vector<function<void(unsigned)>> tasks;
+    for (size_t i = 0; i < rows.size(); i++)
+    {
+        SweepRow *row = &rows[i];
+        tasks.push_back([row, &grid, &workload, &pageReferences, &tracePath](unsigned) {
+            if (row->scheduling)
+            {
+                SimulationOptions options((SchedulingPolicy)row->policy);
+                options.setQuantum(row->quantum);
+                options.seed = grid.seed * 1000003ULL + row->replicate;
+                if (grid.randomProcesses <= 0)
+                {
+                    row->simulation = SchedulerSimulator::run(workload, options);
+                    return;
+                }
+                WorkloadGenerator generator(grid.seed * 1000003ULL + row->replicate);
+                row->simulation = SchedulerSimulator::run(generator.generate(grid.workload, grid.randomProcesses), options);
+            }
+            else if (tracePath.empty())
+                row->replacement = runReplacement((ReplacementAlgorithm)row->policy, row->quantum, pageReferences, false);
+            else
+                row->failed = !runReplacementTrace((ReplacementAlgorithm)row->policy, row->quantum, tracePath, row->replacement);
+        });
+    }
+    pool.run(tasks);
+    return rows;
+}
+
+// Bounded multi-producer, single-consumer ring using the same per-cell
+// sequence numbers as AsyncLogger: any thread may push, only the owner pops.
+// Values are exchanged with the cells by swap, so a push hands the caller
+// the buffer a previous message left behind and payloads are never copied.
+// The cell count is rounded up to a power of two, but at most limit values
+// are queued at once.
+template <typename T>
+class BoundedMpscRing
+{
+private:
+    struct Cell
+    {
+        atomic<size_t> sequence;
+        T value;
+    };
+
+    unique_ptr<Cell[]> cells;
+    size_t mask;
+    size_t limit;
+    atomic<size_t> enqueuePos;
+    atomic<size_t> dequeuePos; // Written by the consumer only
+
+public:
+    explicit BoundedMpscRing(size_t capacity) : limit(max<size_t>(capacity, 1)), enqueuePos(0), dequeuePos(0)
+    {
+        size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+        cells.reset(new Cell[size]);
+        mask = size - 1;
+        for (size_t i = 0; i < size; i++)
+            cells[i].sequence.store(i, memory_order_relaxed);
+    }
+
+    // Swap value into the ring; false (and value untouched) when full
+    bool push(T &value)
+    {
+        size_t pos = enqueuePos.load(memory_order_relaxed);
+        Cell *cell;
+        while (true)
+        {
+            cell = &cells[pos & mask];
+            intptr_t diff = (intptr_t)cell->sequence.load(memory_order_acquire) - (intptr_t)pos;
+            if (diff == 0)
+            {
+                // A stale consumer position only makes the ring look fuller
+                if (pos - dequeuePos.load(memory_order_acquire) >= limit)
+                    return false;
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+                return false;
+            else
+                pos = enqueuePos.load(memory_order_relaxed);
+        }
+        swap(cell->value, value);
+        cell->sequence.store(pos + 1, memory_order_release);
+        return true;
+    }
+
+    // Swap the oldest value out into value; false when empty
+    bool pop(T &value)
+    {
+        size_t pos = dequeuePos.load(memory_order_relaxed);
+        Cell &cell = cells[pos & mask];
+        if (cell.sequence.load(memory_order_acquire) != pos + 1)
+            return false;
+        swap(cell.value, value);
+        cell.sequence.store(pos + mask + 1, memory_order_release);
+        dequeuePos.store(pos + 1, memory_order_release);
+        return true;
+    }
+
+    // Call visit(value) for each queued value, oldest first. Producers must be quiet.
+    template <typename Visit>
+    void forEach(Visit visit) const
+    {
+        for (size_t pos = dequeuePos.load(memory_order_relaxed), end = enqueuePos.load(memory_order_acquire); pos != end; pos++)
+            visit(cells[pos & mask].value);
+    }
+
+    size_t size() const { return enqueuePos.load(memory_order_acquire) - dequeuePos.load(memory_order_relaxed); }
+    size_t capacity() const { return limit; }
+};
+
+// A message between processes; the payload buffer travels with it
+struct Message
+{
+    int sender;
+    string payload;
+
+    Message() : sender(0) {}
+};
+
+inline void swap(Message &a, Message &b)
+{
+    std::swap(a.sender, b.sender);
+    a.payload.swap(b.payload);
+}
+
+// Per-process mailbox. waiting is set while the owner is blocked in receive.
+struct Mailbox
+{
+    BoundedMpscRing<Message> ring;
+    bool waiting;
+
+    explicit Mailbox(size_t capacity) : ring(capacity), waiting(false) {}
+};
+
+// Send outcome
+enum SendStatus
+{
+    SEND_OK,
+    SEND_WOKE,      // Delivered and the receiver, blocked in receive, was woken
+    SEND_FULL,      // Receiver's mailbox is at capacity; nothing was sent
+    SEND_NOT_FOUND,
+    SEND_STATUS_COUNT
+};
+
+const char *sendStatusName(SendStatus status)
+{
+    static const char *names[SEND_STATUS_COUNT] = {"ok", "woke", "full", "not_found"};
+    return names[status];
+}
+
+// Receive outcome
+enum ReceiveStatus
+{
+    RECEIVE_OK,
+    RECEIVE_BLOCKED,   // Mailbox empty; the process moved to the blocked queue
+    RECEIVE_NOT_FOUND, // No such process, or it is not ready or running
+    RECEIVE_STATUS_COUNT
+};
+
+const char *receiveStatusName(ReceiveStatus status)
+{
+    static const char *names[RECEIVE_STATUS_COUNT] = {"ok", "blocked", "not_found"};
+    return names[status];
+}
+
+// Snapshot file layout. The header is followed by fixed-size arrays, each
+// starting on an 8-byte boundary, in this order: process records (ready,
+// running, then blocked queue, each in queue order), address spaces, their
+// mappings,
+// one Clock referenced flag per frame, TLB slots, message headers and message
+// payloads.
+// Everything is stored in host byte order; the endian tag rejects foreign files.
+struct SnapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t endianTag;
+    uint32_t headerSize;
+    uint32_t processRecordSize;
+    int32_t processCounter;
+    int32_t timeQuantum;
+    int32_t adaptiveQuantum;
+    int32_t feedbackLevels;
+    int32_t feedbackBaseQuantum;
+    int32_t boostInterval;
+    int32_t preemptivePolicy; // POLICY_SRTF, POLICY_EDF or POLICY_COUNT (off)
+    int32_t cpuHolder;
+    int64_t feedbackClock;
+    int64_t nextBoost;
+    int64_t strideGlobalPass;
+    int64_t preemptions;
+    uint64_t rngState[4];
+    double arrivalClock;
+    uint64_t mailboxCapacity;
+    int32_t frameSize;
+    int32_t vmFrames;
+    int32_t vmPageSize;
+    int32_t vmTlbSets;
+    int32_t vmTlbWays;
+    int32_t vmAddressBits;
+    uint64_t vmClockHand;
+    uint32_t vmTlbClock;
+    uint32_t reserved;
+    int64_t vmCounters[6]; // VmStats fields in declaration order
+    uint64_t queueLength[3]; // Ready, running, blocked
+    uint64_t spaceCount;
+    uint64_t mappingCount;
+    uint64_t messageCount;
+    uint64_t payloadBytes;
+};
+
+struct SnapshotProcess
+{
+    int32_t pid;
+    int32_t AT;
+    int32_t BT;
+    int32_t remainingBT;
+    int32_t priority;
+    int32_t pageSize;
+    int32_t memoryAllocated;
+    int32_t processSize;
+    int32_t mlfqLevel;
+    int32_t cpuAffinity;
+    int64_t stridePass;
+    int32_t heapIndex[READY_HEAP_COUNT]; // Position in each ready heap (-1 unless ready)
+    int32_t serviceRank;                 // Position in feedback-queue service order (-1 unless ready)
+    int32_t deadline;
+    uint32_t mailboxCapacity;            // 0 = no mailbox
+    uint8_t state;
+    uint8_t waiting;          // Blocked in receive
+    uint8_t reserved[6];
+};
+
+struct SnapshotSpace
+{
+    int32_t pid;
+    uint32_t reserved;
+    uint64_t pageLimit;
+    uint64_t mappings; // Entries of the mapping array that belong to this space
+};
+
+struct SnapshotMapping
+{
+    uint64_t vpn;
+    int32_t frame;
+    uint32_t reserved;
+};
+
+struct SnapshotTlbSlot
+{
+    uint64_t tag; // Tlb::EMPTY for an unused slot
+    int32_t frame;
+    uint32_t lastUse;
+};
+
+struct SnapshotMessage
+{
+    int32_t receiver; // Messages of one mailbox are stored oldest first
+    int32_t sender;
+    uint64_t length;  // Payload bytes, stored back to back after the headers
+};
+
+const char SNAPSHOT_MAGIC[8] = {'E', 'G', 'L', 'S', 'N', 'A', 'P', '\0'};
+const uint32_t SNAPSHOT_VERSION = 3;
+const uint32_t SNAPSHOT_ENDIAN_TAG = 0x01020304;
+
+inline uint64_t snapshotAlign(uint64_t offset)
+{
+    return (offset + 7) & ~(uint64_t)7;
+}
+
+// Whole snapshot file, memory-mapped read-only (read in one call on Windows)
+class SnapshotImage
+{
+private:
+#ifdef _WIN32
+    vector<char> contents;
+#else
+    void *mapped;
+#endif
+    const char *bytes;
+    size_t length;
+
+public:
+    SnapshotImage() : bytes(nullptr), length(0)
+    {
+#ifndef _WIN32
+        mapped = nullptr;
+#endif
+    }
+
+    ~SnapshotImage()
+    {
+#ifndef _WIN32
+        if (mapped)
+            munmap(mapped, length);
+#endif
+    }
+
+    bool open(const string &path)
+    {
+#ifdef _WIN32
+        ifstream file(path.c_str(), ios::binary | ios::ate);
+        if (!file)
+            return false;
+        contents.resize((size_t)file.tellg());
+        file.seekg(0);
+        if (!file.read(contents.data(), contents.size()))
+            return false;
+        bytes = contents.data();
+        length = contents.size();
+        return true;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size <= 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        length = (size_t)info.st_size;
+        int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+        flags |= MAP_POPULATE; // Fault the whole file in with one read-ahead
+#endif
+        mapped = mmap(nullptr, length, PROT_READ, flags, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED)
+        {
+            mapped = nullptr;
+            return false;
+        }
+        madvise(mapped, length, MADV_SEQUENTIAL);
+        bytes = (const char *)mapped;
+        return true;
+#endif
+    }
+
+    const char *data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+// How displayAll() presents the queues
+enum DisplayMode
+{
+    DISPLAY_ALL,     // Every row of every queue
+    DISPLAY_PAGE,    // Summary line and one page of rows per queue (page 0 = top N)
+    DISPLAY_SUMMARY, // Summary line per queue only
+    DISPLAY_DIFF,    // Processes created, moved or destroyed since the last view
+    DISPLAY_MODE_COUNT
+};
+
+const char *displayModeName(DisplayMode mode)
+{
+    static const char *names[DISPLAY_MODE_COUNT] = {"all", "page", "summary", "diff"};
+    return names[mode];
+}
+
+struct DisplayOptions
+{
+    DisplayMode mode;
+    int rows; // Rows per page, and the most changes listed by a diff
+    int page;
+
+    DisplayOptions(DisplayMode viewMode = DISPLAY_PAGE, int pageRows = 20, int pageNumber = 0) : mode(viewMode), rows(pageRows), page(pageNumber) {}
+};
+
+class ProcessManager
+{
+private:
+    ProcessTable processTable;
+    ProcessQueue readyQueue;
+    ProcessQueue runningQueue;
+    ProcessQueue blockedQueue;
+    ProcessHeap<FCFS_HEAP, ArrivesFirst> fcfsHeap;
+    ProcessHeap<PRIORITY_HEAP, HigherPriority> priorityHeap;
+    ProcessHeap<SJF_HEAP, ShorterJob> sjfHeap;
+    ProcessHeap<SRTF_HEAP, ShorterRemaining> srtfHeap; // Both kept only in preemptive mode
+    ProcessHeap<EDF_HEAP, EarlierDeadline> edfHeap;
+    bool remainingKeysStale = false; // Slices were charged to ready processes since srtfHeap was ordered
+    int processCounter;
+    int timeQuantum = 10;        // Time quantum for Round-Robin
+    bool adaptiveQuantum = false; // Derive the quantum from the queued bursts on every pass
+
+    // Multilevel Feedback Queue levels. Ready processes are entered into their
+    // level's queue as they are linked into the ready queue; entries left behind
+    // by processes that have since moved are recognized by a stale ticket.
+    struct FeedbackEntry
+    {
+        Process *process;
+        long long ticket;
+    };
+    vector<CircularRunQueue<FeedbackEntry>> feedbackLevels;
+    deque<CircularRunQueue<FeedbackEntry>> boostedLevels; // Level queues lifted by boosts, served before level 0
+    long long boostTicket = 0;        // Entries with older tickets were queued at the last boost
+    vector<int> feedbackQuanta;       // Slice of each level
+    int boostInterval = 1000;         // Charged ticks between boosts to the top level (0 = never)
+    long long feedbackClock = 0;      // Ticks charged by feedback slices
+    long long nextBoost = 1000;
+    long long feedbackTickets = 0;
+    size_t feedbackEntries = 0;       // Live and stale entries across all levels
+
+    long long strideGlobalPass = 0;   // Pass of the last stride pick; processes rejoin no earlier
+
+    // Preemptive mode, entered by srtf() or edf() and left by any other
+    // policy: the process dispatched last holds the CPU until a ready arrival
+    // that ranks ahead of it takes over. The SRTF and EDF heaps are built on
+    // entry and dropped on exit, so they are maintained only while it lasts.
+    SchedulingPolicy preemptivePolicy = POLICY_COUNT; // POLICY_COUNT = off
+    int cpuHolder = 0;                                // PID on the CPU (0 = none)
+    long long preemptions = 0;
+
+    int frameSize = 256;        // Frame size for paging
+    VirtualMemory memory;       // Page tables, frames and TLB of the virtual memory model
+    WorkloadGenerator generator; // Source of synthetic processes and page references
+    vector<unique_ptr<Mailbox>> mailboxes; // Indexed by PID, created on first use
+    size_t mailboxCapacity = 16;
+    static const int MAX_MAILBOX_CAPACITY = 1 << 20;
+    AsyncLogger logger;
+    unique_ptr<TraceWriter> trace;
+    long long traceClock; // Sequence number of the next trace record
+    ostream *consoleStream; // Destination of informational messages
+    ostream mutedStream;    // Discards everything written to it
+
+    // Queue lengths published for stats dumps, which run on their own thread
+    atomic<int> queueGauges[TRACE_QUEUE_BLOCKED + 1];
+    atomic<int> readyPeak;
+    DisplayOptions displayOptions;
+    vector<uint8_t> shownState; // State + 1 of each PID at the last view (0 = absent)
+    const chrono::steady_clock::time_point statsEpoch;
+    thread statsThread;
+    mutex statsMutex;
+    condition_variable statsWake;
+    bool statsStopping = false;
+
+    TraceQueue traceQueueOf(const ProcessQueue &queue) const
+    {
+        if (&queue == &readyQueue)
+            return TRACE_QUEUE_READY;
+        if (&queue == &runningQueue)
+            return TRACE_QUEUE_RUNNING;
+        if (&queue == &blockedQueue)
+            return TRACE_QUEUE_BLOCKED;
+        return TRACE_QUEUE_NONE;
+    }
+
+    void publishQueueLength(const ProcessQueue &queue)
+    {
+#if EAGLE_INSTRUMENT
+        queueGauges[traceQueueOf(queue)].store(queue.size, memory_order_relaxed);
+        if (&queue == &readyQueue && queue.size > readyPeak.load(memory_order_relaxed))
+            readyPeak.store(queue.size, memory_order_relaxed);
+#else
+        (void)queue;
+#endif
+    }
+
+    // Utility function to add a process to a queue, keeping the ready heaps in sync
+    void linkProcess(ProcessQueue &queue, Process *process)
+    {
+        queue.pushFront(process);
+        publishQueueLength(queue);
+        if (&queue == &readyQueue)
+        {
+            fcfsHeap.push(process);
+            priorityHeap.push(process);
+            sjfHeap.push(process);
+            if (preemptiveMode())
+            {
+                srtfHeap.push(process);
+                edfHeap.push(process);
+            }
+            enterFeedbackLevel(process);
+        }
+    }
+
+    // Link ready processes for count jobs without restoring heap order;
+    // restoreReadyHeaps must follow before the heaps are used
+    void appendReadyJobs(const SimJob *jobs, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            const SimJob &job = jobs[i];
+            Process *process = processTable.allocate(++processCounter);
+            process->AT = job.AT;
+            process->BT = job.burst;
+            process->remainingBT = job.remainingBT;
+            process->priority = job.priority;
+            process->page_size = 0;
+            process->memory_allocated = 0;
+            process->process_size = 0;
+            process->state = STATE_READY;
+            process->cpuAffinity = job.cpu;
+            process->deadline = job.deadline;
+            readyQueue.pushFront(process);
+            fcfsHeap.append(process);
+            priorityHeap.append(process);
+            sjfHeap.append(process);
+            if (preemptiveMode())
+            {
+                srtfHeap.append(process);
+                edfHeap.append(process);
+            }
+            enterFeedbackLevel(process);
+            if (trace)
+                trace->record(TRACE_CREATE, process->process_id, traceClock++, job.AT, job.burst, job.priority);
+        }
+        publishQueueLength(readyQueue);
+    }
+
+    void restoreReadyHeaps(size_t appended)
+    {
+        fcfsHeap.heapify(appended);
+        priorityHeap.heapify(appended);
+        sjfHeap.heapify(appended);
+        if (preemptiveMode())
+        {
+            srtfHeap.heapify(appended);
+            edfHeap.heapify(appended);
+        }
+    }
+
+    bool preemptiveMode() const { return preemptivePolicy != POLICY_COUNT; }
+
+    // Switch to a preemptive policy, building its heaps over the ready queue
+    // in O(n) the first time
+    void enterPreemptiveMode(SchedulingPolicy policy)
+    {
+        if (!preemptiveMode())
+        {
+            srtfHeap.reserve(readyQueue.size);
+            edfHeap.reserve(readyQueue.size);
+            for (Process *curr = readyQueue.head; curr; curr = curr->next)
+            {
+                srtfHeap.append(curr);
+                edfHeap.append(curr);
+            }
+            srtfHeap.heapify(srtfHeap.size());
+            edfHeap.heapify(edfHeap.size());
+            remainingKeysStale = false;
+        }
+        preemptivePolicy = policy;
+    }
+
+    // Leave preemptive mode when a non-preemptive policy dispatches: nothing
+    // holds the CPU any more and the SRTF and EDF heaps are dropped
+    void exitPreemptiveMode()
+    {
+        if (!preemptiveMode())
+            return;
+        for (Process *curr = readyQueue.head; curr; curr = curr->next)
+            curr->heapIndex[SRTF_HEAP] = curr->heapIndex[EDF_HEAP] = -1;
+        srtfHeap.clear();
+        edfHeap.clear();
+        remainingKeysStale = false;
+        preemptivePolicy = POLICY_COUNT;
+        cpuHolder = 0;
+    }
+
+    // Reorder srtfHeap after slices were charged to processes it holds
+    void settleRemainingKeys()
+    {
+        if (!remainingKeysStale)
+            return;
+        srtfHeap.heapify(srtfHeap.size());
+        remainingKeysStale = false;
+    }
+
+    // Append a ready process to the queue of its feedback level
+    void enterFeedbackLevel(Process *process)
+    {
+        process->mlfqLevel = min(process->mlfqLevel, (int)feedbackLevels.size() - 1);
+        process->mlfqTicket = feedbackTickets++;
+        feedbackLevels[process->mlfqLevel].push(FeedbackEntry{process, process->mlfqTicket});
+        // Processes that leave the ready queue leave their entries behind
+        if (++feedbackEntries > 2 * (size_t)readyQueue.size + 4096)
+            rebuildFeedbackLevels();
+    }
+
+    // A ready process queued before the last boost is back on the top level
+    void settleBoost(Process *process)
+    {
+        if (process->mlfqTicket < boostTicket)
+            process->mlfqLevel = 0;
+    }
+
+    // Pop the next live entry from queue, or return nullptr once it is empty
+    Process *nextLiveEntry(CircularRunQueue<FeedbackEntry> &queue)
+    {
+        while (!queue.empty())
+        {
+            FeedbackEntry entry = queue.pop();
+            feedbackEntries--;
+            if (entry.process->queue == &readyQueue && entry.process->mlfqTicket == entry.ticket)
+                return entry.process;
+        }
+        return nullptr;
+    }
+
+    // Take the first ready process from the highest non-empty feedback level
+    Process *nextFeedbackProcess()
+    {
+        for (; !boostedLevels.empty(); boostedLevels.pop_front())
+            if (Process *process = nextLiveEntry(boostedLevels.front()))
+            {
+                settleBoost(process);
+                return process;
+            }
+        for (size_t level = 0; level < feedbackLevels.size(); level++)
+            if (Process *process = nextLiveEntry(feedbackLevels[level]))
+                return process;
+        return nullptr;
+    }
+
+    // Return every ready process to the top level without touching them: the
+    // level queues move whole behind those of earlier boosts, and each process
+    // has its level reset by settleBoost when it next leaves the ready queue
+    void boostFeedbackLevels()
+    {
+        for (size_t level = 0; level < feedbackLevels.size(); level++)
+            if (!feedbackLevels[level].empty())
+            {
+                boostedLevels.push_back(CircularRunQueue<FeedbackEntry>());
+                swap(boostedLevels.back(), feedbackLevels[level]);
+            }
+        boostTicket = feedbackTickets;
+    }
+
+    // Drop stale feedback entries and settle pending boosts; service order is kept
+    void rebuildFeedbackLevels()
+    {
+        vector<CircularRunQueue<FeedbackEntry>> rebuilt(feedbackLevels.size());
+        for (; !boostedLevels.empty(); boostedLevels.pop_front())
+            while (Process *process = nextLiveEntry(boostedLevels.front()))
+            {
+                settleBoost(process);
+                rebuilt[0].push(FeedbackEntry{process, process->mlfqTicket});
+            }
+        for (size_t level = 0; level < feedbackLevels.size(); level++)
+            while (Process *process = nextLiveEntry(feedbackLevels[level]))
+                rebuilt[level].push(FeedbackEntry{process, process->mlfqTicket});
+        feedbackEntries = 0;
+        for (size_t level = 0; level < rebuilt.size(); level++)
+            feedbackEntries += rebuilt[level].size();
+        feedbackLevels.swap(rebuilt);
+    }
+
+    // Utility function to take a process off a queue, keeping the ready heaps in sync
+    void unlinkProcess(ProcessQueue &queue, Process *process)
+    {
+        queue.remove(process);
+        publishQueueLength(queue);
+        if (&queue == &readyQueue)
+        {
+            settleBoost(process);
+            fcfsHeap.remove(process);
+            priorityHeap.remove(process);
+            sjfHeap.remove(process);
+            if (preemptiveMode())
+            {
+                srtfHeap.remove(process);
+                edfHeap.remove(process);
+            }
+        }
+    }
+
+    // Utility function to delete a process from a queue
+    void deleteProcess(ProcessQueue &queue, Process *target)
+    {
+        if (target->queue != &queue)
+            return;
+        unlinkProcess(queue, target);
+        memory.destroySpace(target->process_id);
+        if (target->process_id < (int)mailboxes.size())
+            mailboxes[target->process_id].reset();
+        processTable.release(target);
+    }
+
+    // Utility function to find a process in a queue by ID
+    Process *findProcess(const ProcessQueue &queue, int pid)
+    {
+        Process *process = processTable.lookup(pid);
+        if (process && process->queue == &queue)
+            return process;
+        return nullptr;
+    }
+
+    // Utility function to move a process from one queue to another
+    bool moveProcess(ProcessQueue &from, ProcessQueue &to, int pid, ProcessState newState, TraceEventType event)
+    {
+        Process *process = findProcess(from, pid);
+        if (!process)
+            return false;
+        if (trace)
+            trace->record(event, pid, traceClock++, traceQueueOf(from), traceQueueOf(to));
+        if (logEnabled(LOG_DEBUG))
+            logAction("Process " + to_string(process->process_id) + " moved to " + stateName(newState), LOG_DEBUG);
+        Instrumentation::add(transitionCounter(process->state, newState));
+        process->state = newState;
+        unlinkProcess(from, process);
+        linkProcess(to, process);
+        if (&to == &readyQueue && &from != &runningQueue)
+            preemptForArrival();
+        return true;
+    }
+
+    // Append one row of the process table to a display buffer
+    static void appendRow(string &buffer, const Process *process, const char *previous = nullptr)
+    {
+        char line[160];
+        int length = snprintf(line, sizeof(line), "%d\t\t%d\t\t%d\t\t%d\t\t%d\t\t%s", process->process_id, process->AT, process->BT, process->remainingBT,
+                              process->priority, stateName(process->state));
+        buffer.append(line, length);
+        if (previous)
+            buffer.append("\t\t").append(previous);
+        buffer += '\n';
+    }
+
+    // Append a process list (one page of it in page mode, none in summary mode)
+    void appendList(string &buffer, const char *title, const ProcessQueue &queue, const DisplayOptions &options)
+    {
+        buffer.append(title).append(":\n");
+        if (options.mode != DISPLAY_ALL)
+        {
+            long long burst = 0, remaining = 0;
+            int minPriority = INT_MAX, maxPriority = INT_MIN, suspended = 0;
+            for (const Process *curr = queue.head; curr; curr = curr->next)
+            {
+                burst += curr->BT;
+                remaining += curr->remainingBT;
+                minPriority = min(minPriority, curr->priority);
+                maxPriority = max(maxPriority, curr->priority);
+                suspended += curr->state == STATE_SUSPENDED;
+            }
+            char line[200];
+            int length = queue.size ? snprintf(line, sizeof(line), "%d processes, mean burst %.1f, mean remaining %.1f, priority %d-%d, %d suspended\n",
+                                               queue.size, (double)burst / queue.size, (double)remaining / queue.size, minPriority, maxPriority, suspended)
+                                    : snprintf(line, sizeof(line), "0 processes\n");
+            buffer.append(line, length);
+            if (options.mode == DISPLAY_SUMMARY || !queue.head)
+                return;
+        }
+        else if (!queue.head)
+        {
+            buffer.append("Queue is empty.\n");
+            return;
+        }
+        long long first = options.mode == DISPLAY_PAGE ? (long long)options.page * options.rows : 0;
+        long long last = options.mode == DISPLAY_PAGE ? min<long long>(first + options.rows, queue.size) : queue.size;
+        if (first >= last)
+        {
+            buffer.append("No rows on page " + to_string(options.page) + ".\n");
+            return;
+        }
+        buffer.append("Process ID\tArrival Time\tBurst Time\tRemaining BT\tPriority\tState\n");
+        const Process *curr = queue.head;
+        for (long long i = 0; i < first; i++)
+            curr = curr->next;
+        for (long long i = first; i < last; i++, curr = curr->next)
+            appendRow(buffer, curr);
+        if (options.mode == DISPLAY_PAGE && (first > 0 || last < queue.size))
+            buffer.append("Rows " + to_string(first + 1) + "-" + to_string(last) + " of " + to_string(queue.size) + " (page " + to_string(options.page) + ").\n");
+    }
+
+    // Append the processes whose state differs from shownState, then the
+    // destroyed ones, listing at most options.rows of them
+    void appendChanges(string &buffer, const DisplayOptions &options)
+    {
+        long long created = 0, moved = 0, destroyed = 0, listed = 0;
+        string rows;
+        const ProcessQueue *queues[] = {&readyQueue, &runningQueue, &blockedQueue};
+        for (const ProcessQueue *queue : queues)
+            for (const Process *curr = queue->head; curr; curr = curr->next)
+            {
+                uint8_t shown = curr->process_id < (int)shownState.size() ? shownState[curr->process_id] : 0;
+                if (shown == curr->state + 1)
+                    continue;
+                (shown ? moved : created)++;
+                if (listed++ < options.rows)
+                    appendRow(rows, curr, shown ? stateName((ProcessState)(shown - 1)) : "New");
+            }
+        for (size_t pid = 1; pid < shownState.size(); pid++)
+            if (shownState[pid] && !processTable.lookup((int)pid))
+            {
+                destroyed++;
+                if (listed++ < options.rows)
+                    rows.append(to_string(pid)).append("\t\t-\t\t-\t\t-\t\t-\t\tDestroyed\t").append(stateName((ProcessState)(shownState[pid] - 1))).append("\n");
+            }
+        buffer.append("Changes since the last view: " + to_string(created) + " created, " + to_string(moved) + " moved, " + to_string(destroyed) + " destroyed.\n");
+        if (listed == 0)
+            return;
+        buffer.append("Process ID\tArrival Time\tBurst Time\tRemaining BT\tPriority\tState\t\tWas\n");
+        buffer.append(rows);
+        if (listed > options.rows)
+            buffer.append("... and " + to_string(listed - options.rows) + " more.\n");
+    }
+
+    // Remember the state of every process as the baseline for the next diff
+    void recordShownState()
+    {
+        shownState.assign((size_t)processCounter + 1, 0);
+        const ProcessQueue *queues[] = {&readyQueue, &runningQueue, &blockedQueue};
+        for (const ProcessQueue *queue : queues)
+            for (const Process *curr = queue->head; curr; curr = curr->next)
+                shownState[curr->process_id] = curr->state + 1;
+    }
+
+    // Dispatch the head of a ready heap, or every process in heap order when
+    // drainAll is set; returns the PID dispatched last (0 if none)
+    template <typename Heap>
+    int dispatchFrom(Heap &heap, bool drainAll, SchedulingPolicy policy)
+    {
+        ScopedTimer timer(TIMER_SCHEDULING);
+        int last = 0;
+        do
+        {
+            if (heap.empty())
+                break;
+            last = heap.top()->process_id;
+            dispatchProcess(last);
+            Instrumentation::add(COUNTER_DISPATCH + policy);
+        } while (drainAll);
+        return last;
+    }
+
+    // In preemptive mode, hand the CPU to the best ready process if it ranks
+    // ahead of the holder, which goes back to the ready queue. Checking the
+    // heap top rather than the arrival also covers bulk arrivals.
+    void preemptForArrival()
+    {
+        if (!preemptiveMode() || cpuHolder == 0)
+            return;
+        Process *holder = processTable.lookup(cpuHolder);
+        if (!holder || holder->queue != &runningQueue)
+        {
+            cpuHolder = 0;
+            return;
+        }
+        settleRemainingKeys();
+        Process *best = preemptivePolicy == POLICY_SRTF ? srtfHeap.top() : edfHeap.top();
+        if (!best || !(preemptivePolicy == POLICY_SRTF ? ShorterRemaining()(best, holder) : EarlierDeadline()(best, holder)))
+            return;
+        int displaced = cpuHolder;
+        cpuHolder = best->process_id;
+        moveProcess(runningQueue, readyQueue, displaced, STATE_READY, TRACE_MOVE);
+        dispatchProcess(cpuHolder);
+        preemptions++;
+        Instrumentation::add(COUNTER_PREEMPTION);
+        Instrumentation::add(COUNTER_DISPATCH + preemptivePolicy);
+        if (logEnabled(LOG_INFO))
+            logAction("Process " + to_string(cpuHolder) + " preempted Process " + to_string(displaced) + " under " + policyName(preemptivePolicy) + ".");
+    }
+
+    // Run one proportional-share quantum of process, item in shares. Returns
+    // true when the process needed no more than the quantum and was dispatched.
+    bool runShareSlice(Process *process, int item, ShareLedger &shares)
+    {
+        int slice = min(timeQuantum, process->remainingBT);
+        shares.check(item);
+        shares.advance(slice);
+        shares.charge(item, slice);
+        shares.check(item);
+        if (process->remainingBT <= timeQuantum)
+        {
+            shares.leave(item);
+            dispatchProcess(process->process_id);
+            return true;
+        }
+        process->remainingBT -= timeQuantum;
+        remainingKeysStale = true;
+        return false;
+    }
+
+    // Print each priority's service against its ticket share and log the
+    // pass; returns the worst lag in ticks
+    double reportShares(SchedulingPolicy policy, ShareLedger &shares, int slices, int dispatched)
+    {
+        Instrumentation::add(COUNTER_DISPATCH + policy, dispatched);
+        if (slices == 0)
+            return 0;
+        vector<TenantShare> tenants = shares.shares();
+        console() << "Priority\tTickets\t\tProcesses\tReceived\tEntitled\tMax Lag" << endl;
+        for (const TenantShare &share : tenants)
+            console() << share.priority << "\t\t" << share.tickets << "\t\t" << share.processes << "\t\t" << share.received << "\t\t" << share.entitled << "\t\t" << share.maxLag << "\n";
+        console() << "Fairness error: " << shares.fairnessError() << " ticks" << endl;
+        logAction(string(policyName(policy)) + " pass: " + to_string(slices) + " slices, " + to_string(dispatched) + " dispatched, fairness error " +
+                  to_string(shares.fairnessError()) + " ticks.");
+        return shares.fairnessError();
+    }
+
+    // One Round-Robin pass over the ready processes whose priority is in
+    // [minPriority, maxPriority]. The ready queue is rotated as a circular FIFO:
+    // a process that needs more than one slice is charged a quantum and moved
+    // to the tail, any other is dispatched. Processes outside the level are
+    // rotated untouched, so the queue keeps its relative order.
+    void roundRobinLevel(int minPriority, int maxPriority, SchedulingPolicy policy)
+    {
+        int slice = timeQuantum;
+        if (adaptiveQuantum)
+        {
+            long long queuedBurst = 0;
+            int queued = 0;
+            for (Process *curr = readyQueue.head; curr; curr = curr->next)
+                if (curr->priority >= minPriority && curr->priority <= maxPriority)
+                {
+                    queuedBurst += curr->remainingBT;
+                    queued++;
+                }
+            slice = queued ? (int)max(1LL, (queuedBurst + queued - 1) / queued) : 1;
+        }
+
+        int slices = 0, dispatched = 0, switches = 0;
+        Process *previous = nullptr; // Process that ran the last slice
+        for (int n = readyQueue.size; n > 0; n--)
+        {
+            Process *curr = readyQueue.head;
+            if (curr->priority >= minPriority && curr->priority <= maxPriority)
+            {
+                slices++;
+                if (previous && previous != curr)
+                    switches++;
+                previous = curr;
+                if (curr->remainingBT <= slice)
+                {
+                    dispatchProcess(curr->process_id);
+                    dispatched++;
+                    continue;
+                }
+                curr->remainingBT -= slice;
+                remainingKeysStale = true;
+            }
+            readyQueue.rotate();
+        }
+        Instrumentation::add(COUNTER_DISPATCH + policy, dispatched);
+        if (slices > 0)
+            logAction("Round-Robin pass with quantum " + to_string(slice) + ": " + to_string(slices) + " slices, " + to_string(dispatched) + " dispatched, " + to_string(switches) + " context switches.");
+    }
+
+    // Stream for informational messages; muted in batch mode
+    ostream &console()
+    {
+        return *consoleStream;
+    }
+
+    // Utility functions to print and log page replacement results
+    void reportLRU(int numFrames, const ReplacementResult &result)
+    {
+        logAction("LRU with " + to_string(numFrames) + " frames over " + to_string(result.references()) + " references: " + to_string(result.hits) + " hits, " + to_string(result.faults) + " faults.");
+        console() << "Page hits: " << result.hits << ", page faults: " << result.faults << " (fault rate " << result.faultRate() * 100 << "%)" << endl;
+        console() << "Final frame contents: ";
+        for (int frame : result.frames)
+            console() << frame << " ";
+        console() << endl;
+    }
+
+    void reportComparison(int numFrames, const vector<ReplacementResult> &results)
+    {
+        console() << "Policy\t\tHits\t\tFaults\t\tFault Rate" << endl;
+        for (size_t a = 0; a < results.size(); a++)
+            console() << replacementName((ReplacementAlgorithm)a) << "\t\t" << results[a].hits << "\t\t" << results[a].faults << "\t\t" << results[a].faultRate() * 100 << "%\n";
+        console() << flush;
+        logAction("Compared replacement policies with " + to_string(numFrames) + " frames over " + to_string(results.empty() ? 0 : results[0].references()) + " references.");
+    }
+
+    // Print and log the counters accumulated since before
+    VmStats reportMemoryRun(int pid, const VmStats &before, double seconds)
+    {
+        const VmStats &after = memory.counters();
+        VmStats run;
+        run.accesses = after.accesses - before.accesses;
+        run.tlbHits = after.tlbHits - before.tlbHits;
+        run.tlbMisses = after.tlbMisses - before.tlbMisses;
+        run.pageFaults = after.pageFaults - before.pageFaults;
+        run.evictions = after.evictions - before.evictions;
+        run.invalid = after.invalid - before.invalid;
+        Instrumentation::add(COUNTER_PAGE_HIT, run.accesses - run.pageFaults - run.invalid);
+        Instrumentation::add(COUNTER_PAGE_FAULT, run.pageFaults);
+        Instrumentation::addTime(TIMER_MEMORY, (uint64_t)(seconds * 1e9));
+        console() << run.accesses << " accesses: " << run.tlbHits << " TLB hits (" << run.tlbHitRate() * 100 << "%), " << run.tlbMisses << " TLB misses, "
+                  << run.pageFaults << " page faults, " << run.evictions << " evictions, " << run.invalid << " invalid" << endl;
+        if (run.accesses > 0)
+            console() << seconds * 1e9 / run.accesses << " ns per access" << endl;
+        logAction("Ran " + to_string(run.accesses) + " memory accesses for Process " + to_string(pid) + ": " + to_string(run.pageFaults) + " page faults, " +
+                  to_string(run.tlbMisses) + " TLB misses.");
+        return run;
+    }
+
+    vector<MissRatioPoint> reportMissRatioCurve(const StackDistanceAnalyzer &analyzer, int maxFrames, const string &csvPath)
+    {
+        vector<MissRatioPoint> points = analyzer.curve();
+        console() << "Frames\t\tFaults\t\tFault Rate" << endl;
+        for (size_t i = 0; i < points.size(); i++)
+            console() << points[i].frames << "\t\t" << points[i].faults << "\t\t" << points[i].faultRate * 100 << "%\n";
+        console() << flush;
+        if (!csvPath.empty())
+        {
+            if (writeMissRatioCSV(points, csvPath))
+                console() << "Miss-ratio curve written to " << csvPath << endl;
+            else
+                console() << "Unable to write " << csvPath << endl;
+        }
+        logAction("Computed LRU miss-ratio curve for 1-" + to_string(maxFrames) + " frames over " + to_string(analyzer.references()) + " references.");
+        return points;
+    }
+
+    // Utility function to log actions
+    void logAction(const string &action, LogLevel level = LOG_INFO)
+    {
+        logger.log(level, action);
+    }
+
+    // Check before building a message on a hot path
+    bool logEnabled(LogLevel level) const
+    {
+        return logger.enabled(level);
+    }
+
+public:
+    ProcessManager() : processCounter(0), traceClock(0), consoleStream(&cout), mutedStream(nullptr), readyPeak(0), statsEpoch(chrono::steady_clock::now())
+    {
+        for (atomic<int> &gauge : queueGauges)
+            gauge.store(0, memory_order_relaxed);
+        if (!logger.open("process_log.txt"))
+        {
+            cerr << "Unable to open log file." << endl;
+            exit(1);
+        }
+        configureFeedbackQueue(3, 10, 1000);
+        logAction("Process Manager initialized.");
+    }
+
+    ~ProcessManager()
+    {
+        stopStatsDump();
+        logAction("Process Manager terminated.");
+        logger.close();
+    }
+
+    // Public utility functions for input validation
+    int getValidatedChoice(int min, int max)
+    {
+        int choice;
+        while (true)
+        {
+            cout << "Enter your choice (" << min << "-" << max << "): ";
+            cin >> choice;
+            if (cin.fail() || choice < min || choice > max)
+            {
+                cin.clear(); // clear input buffer to restore cin to a usable state
+                cin.ignore(INT_MAX, '\n'); // ignore last input
+                cout << "Invalid choice, please try again." << endl;
+            }
+            else
+            {
+                cin.ignore(INT_MAX, '\n'); // clear input buffer
+                break;
+            }
+        }
+        return choice;
+    }
+
+    int getValidatedProcessID()
+    {
+        int pid;
+        while (true)
+        {
+            cout << "Enter Process ID: ";
+            cin >> pid;
+            if (cin.fail() || pid <= 0)
+            {
+                cin.clear();
+                cin.ignore(INT_MAX, '\n');
+                cout << "Invalid Process ID, please try again." << endl;
+            }
+            else
+            {
+                cin.ignore(INT_MAX, '\n');
+                break;
+            }
+        }
+        return pid;
+    }
+
+    // Record every state transition to a binary trace file
+    bool startTrace(const string &path)
+    {
+        unique_ptr<TraceWriter> writer(new TraceWriter());
+        if (!writer->open(path))
+            return false;
+        trace.swap(writer);
+        logAction("Binary trace started: " + path);
+        return true;
+    }
+
+    void stopTrace()
+    {
+        if (trace)
+        {
+            trace->close();
+            trace.reset();
+            logAction("Binary trace stopped.");
+        }
+    }
+
+    TraceWriter *traceWriter()
+    {
+        return trace.get();
+    }
+
+    // Write one "stats key=value ..." line: queue lengths, log bytes and the
+    // instrumentation counters (transitions and dispatches only where non-zero).
+    // Safe to call from any thread.
+    void writeStats(ostream &out)
+    {
+#if EAGLE_INSTRUMENT
+        static const char *stateKeys[STATE_COUNT] = {"ready", "running", "blocked", "suspended"};
+        CounterSnapshot snapshot = Instrumentation::snapshot();
+        out << "stats elapsed_ms=" << chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - statsEpoch).count()
+            << " ready=" << queueGauges[TRACE_QUEUE_READY].load(memory_order_relaxed) << " running=" << queueGauges[TRACE_QUEUE_RUNNING].load(memory_order_relaxed)
+            << " blocked=" << queueGauges[TRACE_QUEUE_BLOCKED].load(memory_order_relaxed) << " ready_peak=" << readyPeak.load(memory_order_relaxed)
+            << " log_bytes=" << logger.bytesLogged() << " page_hits=" << snapshot.counters[COUNTER_PAGE_HIT] << " page_faults=" << snapshot.counters[COUNTER_PAGE_FAULT]
+            << " messages_sent=" << snapshot.counters[COUNTER_MESSAGE_SENT] << " messages_received=" << snapshot.counters[COUNTER_MESSAGE_RECEIVED]
+            << " receive_blocks=" << snapshot.counters[COUNTER_RECEIVE_BLOCK] << " preemptions=" << snapshot.counters[COUNTER_PREEMPTION];
+        for (int from = 0; from < STATE_COUNT; from++)
+            for (int to = 0; to < STATE_COUNT; to++)
+                if (uint64_t moves = snapshot.counters[transitionCounter((ProcessState)from, (ProcessState)to)])
+                    out << " move_" << stateKeys[from] << '_' << stateKeys[to] << '=' << moves;
+        for (int policy = 0; policy < POLICY_COUNT; policy++)
+        {
+            if (uint64_t dispatches = snapshot.counters[COUNTER_DISPATCH + policy])
+                out << " dispatch_" << policyKey((SchedulingPolicy)policy) << '=' << dispatches;
+            if (uint64_t dispatches = snapshot.counters[COUNTER_SIM_DISPATCH + policy])
+                out << " sim_dispatch_" << policyKey((SchedulingPolicy)policy) << '=' << dispatches;
+        }
+        for (int timer = 0; timer < TIMER_COUNT; timer++)
+            if (snapshot.timerCalls[timer])
+                out << ' ' << timerName((TimerId)timer) << "_ms=" << snapshot.timerNanos[timer] / 1e6 << ' ' << timerName((TimerId)timer) << "_calls=" << snapshot.timerCalls[timer];
+        out << '\n';
+#else
+        out << "stats instrumentation=off\n";
+#endif
+    }
+
+    // Zero the counters and the ready-queue high-water mark
+    void resetStats()
+    {
+        Instrumentation::reset();
+        readyPeak.store(readyQueue.size, memory_order_relaxed);
+    }
+
+    // Append a stats line to path every intervalMs milliseconds, and a final
+    // one when dumping stops
+    bool startStatsDump(const string &path, int intervalMs)
+    {
+        if (!EAGLE_INSTRUMENT || intervalMs <= 0)
+            return false;
+        stopStatsDump();
+        shared_ptr<ofstream> file(new ofstream(path.c_str(), ios::app));
+        if (!*file)
+            return false;
+        statsStopping = false;
+        statsThread = thread([this, file, intervalMs]() {
+            unique_lock<mutex> lock(statsMutex);
+            while (!statsWake.wait_for(lock, chrono::milliseconds(intervalMs), [this]() { return statsStopping; }))
+            {
+                writeStats(*file);
+                file->flush();
+            }
+            writeStats(*file);
+        });
+        logAction("Stats dump started: " + path + " every " + to_string(intervalMs) + " ms.");
+        return true;
+    }
+
+    void stopStatsDump()
+    {
+        if (!statsThread.joinable())
+            return;
+        {
+            lock_guard<mutex> lock(statsMutex);
+            statsStopping = true;
+        }
+        statsWake.notify_one();
+        statsThread.join();
+        logAction("Stats dump stopped.");
+    }
+
+    // Enable or silence informational messages printed by operations
+    void setConsoleOutput(bool enabled)
+    {
+        consoleStream = enabled ? &cout : &mutedStream;
+    }
+
+    // Drop log records below level (per-process transitions are LOG_DEBUG)
+    void setLogLevel(LogLevel level)
+    {
+        logger.setLevel(level);
+    }
+
+    // Create a new process
+    int createProcess(int AT, int BT, int priority, int deadline = -1)
+    {
+        Process *newProcess = processTable.allocate(++processCounter);
+        newProcess->AT = AT;
+        newProcess->BT = BT;
+        newProcess->remainingBT = BT;
+        newProcess->priority = priority;
+        newProcess->deadline = deadline;
+        newProcess->page_size = 0;
+        newProcess->memory_allocated = 0;
+        newProcess->process_size = 0;
+        newProcess->state = STATE_READY;
+        linkProcess(readyQueue, newProcess);
+        if (trace)
+            trace->record(TRACE_CREATE, newProcess->process_id, traceClock++, AT, BT, priority);
+        if (logEnabled(LOG_DEBUG))
+            logAction("Created Process " + to_string(newProcess->process_id) + " with AT=" + to_string(AT) + ", BT=" + to_string(BT) + ", Priority=" + to_string(priority), LOG_DEBUG);
+        preemptForArrival();
+        return newProcess->process_id;
+    }
+
+    // Preallocate records, PID index and ready heaps for n more processes
+    void reserveProcesses(int n)
+    {
+        if (n <= 0)
+            return;
+        processTable.reserve(n, processCounter + n);
+        fcfsHeap.reserve(readyQueue.size + n);
+        priorityHeap.reserve(readyQueue.size + n);
+        sjfHeap.reserve(readyQueue.size + n);
+        if (preemptiveMode())
+        {
+            srtfHeap.reserve(readyQueue.size + n);
+            edfHeap.reserve(readyQueue.size + n);
+        }
+    }
+
+    // Destroy every process at once; record storage is kept for reuse
+    void destroyAllProcesses()
+    {
+        int destroyed = processTable.size();
+        if (trace)
+        {
+            const ProcessQueue *queues[] = {&readyQueue, &runningQueue, &blockedQueue};
+            for (const ProcessQueue *queue : queues)
+                for (Process *curr = queue->head; curr; curr = curr->next)
+                    trace->record(TRACE_DESTROY, curr->process_id, traceClock++);
+        }
+        readyQueue = runningQueue = blockedQueue = ProcessQueue();
+        publishQueueLength(readyQueue);
+        publishQueueLength(runningQueue);
+        publishQueueLength(blockedQueue);
+        fcfsHeap.clear();
+        priorityHeap.clear();
+        sjfHeap.clear();
+        srtfHeap.clear();
+        edfHeap.clear();
+        remainingKeysStale = false;
+        cpuHolder = 0;
+        feedbackLevels.assign(feedbackLevels.size(), CircularRunQueue<FeedbackEntry>());
+        boostedLevels.clear();
+        feedbackEntries = 0;
+        processTable.reset();
+        memory.clearSpaces();
+        mailboxes.clear();
+        logAction("Destroyed all " + to_string(destroyed) + " processes.");
+    }
+
+    // Add ready processes for count jobs in one pass. The ready heaps are
+    // rebuilt once at the end instead of being sifted per process.
+    void loadWorkload(const SimJob *jobs, size_t count)
+    {
+        reserveProcesses((int)count);
+        appendReadyJobs(jobs, count);
+        restoreReadyHeaps(count);
+        preemptForArrival();
+    }
+
+    // Seed the workload generator; the same seed reproduces the same processes
+    void seedWorkload(uint64_t seed)
+    {
+        generator.seed(seed);
+    }
+
+    // Generate count processes shaped by spec and bulk-load them in chunks,
+    // so memory for the intermediate jobs stays bounded
+    void generateWorkload(const WorkloadSpec &spec, int count)
+    {
+        const int CHUNK = 1 << 16;
+        vector<SimJob> jobs(min(max(count, 0), CHUNK));
+        reserveProcesses(count);
+        for (int done = 0; done < count; done += CHUNK)
+        {
+            size_t n = min(CHUNK, count - done);
+            generator.generate(spec, jobs.data(), n, processCounter + 1);
+            appendReadyJobs(jobs.data(), n);
+        }
+        restoreReadyHeaps(max(count, 0));
+        preemptForArrival();
+        logAction("Generated " + to_string(max(count, 0)) + " processes (arrivals=" + arrivalName(spec.arrivals) + ", bursts=" + burstName(spec.bursts) + ").");
+    }
+
+    // Page reference string with working-set locality
+    vector<int> generatePageReferences(const LocalitySpec &spec, size_t count)
+    {
+        vector<int> references;
+        generator.pageReferences(spec, count, references);
+        return references;
+    }
+
+    // Write the whole manager state to path as a binary snapshot (layout at
+    // SnapshotHeader). Pending feedback-queue boosts are settled first, which
+    // keeps the service order. Trace, log and stats settings are not saved.
+    bool saveSnapshot(const string &path, uint64_t &bytesWritten)
+    {
+        rebuildFeedbackLevels();
+        settleRemainingKeys();
+        SnapshotHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = SNAPSHOT_VERSION;
+        header.endianTag = SNAPSHOT_ENDIAN_TAG;
+        header.headerSize = sizeof(SnapshotHeader);
+        header.processRecordSize = sizeof(SnapshotProcess);
+        header.processCounter = processCounter;
+        header.timeQuantum = timeQuantum;
+        header.adaptiveQuantum = adaptiveQuantum;
+        header.feedbackLevels = (int32_t)feedbackLevels.size();
+        header.feedbackBaseQuantum = feedbackQuanta[0];
+        header.boostInterval = boostInterval;
+        header.preemptivePolicy = preemptivePolicy;
+        header.cpuHolder = cpuHolder;
+        header.preemptions = preemptions;
+        header.feedbackClock = feedbackClock;
+        header.nextBoost = nextBoost;
+        header.strideGlobalPass = strideGlobalPass;
+        memcpy(header.rngState, generator.engine().state(), sizeof(header.rngState));
+        header.arrivalClock = generator.arrivalClock();
+        header.mailboxCapacity = mailboxCapacity;
+        header.frameSize = frameSize;
+        header.vmFrames = memory.frameCount();
+        header.vmPageSize = memory.pageSize();
+        header.vmTlbSets = (int32_t)memory.tlbSets();
+        header.vmTlbWays = memory.tlbWays();
+        header.vmAddressBits = memory.virtualAddressBits();
+        header.vmClockHand = memory.clockHand();
+        header.vmTlbClock = memory.tlbState().useClock();
+        const VmStats &vm = memory.counters();
+        int64_t vmCounters[6] = {vm.accesses, vm.tlbHits, vm.tlbMisses, vm.pageFaults, vm.evictions, vm.invalid};
+        memcpy(header.vmCounters, vmCounters, sizeof(vmCounters));
+
+        vector<int32_t> serviceRank((size_t)processCounter + 1, -1);
+        int32_t rank = 0;
+        for (size_t level = 0; level < feedbackLevels.size(); level++)
+            feedbackLevels[level].forEach([&serviceRank, &rank](const FeedbackEntry &entry) { serviceRank[entry.process->process_id] = rank++; });
+
+        vector<SnapshotProcess> records;
+        records.reserve(processTable.size());
+        const ProcessQueue *queues[] = {&readyQueue, &runningQueue, &blockedQueue};
+        for (int q = 0; q < 3; q++)
+        {
+            header.queueLength[q] = queues[q]->size;
+            for (Process *curr = queues[q]->head; curr; curr = curr->next)
+            {
+                const Mailbox *mailbox = curr->process_id < (int)mailboxes.size() ? mailboxes[curr->process_id].get() : nullptr;
+                SnapshotProcess r;
+                r.pid = curr->process_id;
+                r.AT = curr->AT;
+                r.BT = curr->BT;
+                r.remainingBT = curr->remainingBT;
+                r.priority = curr->priority;
+                r.pageSize = curr->page_size;
+                r.memoryAllocated = curr->memory_allocated;
+                r.processSize = curr->process_size;
+                r.mlfqLevel = curr->mlfqLevel;
+                r.cpuAffinity = curr->cpuAffinity;
+                r.stridePass = curr->stridePass;
+                for (int k = 0; k < READY_HEAP_COUNT; k++)
+                    r.heapIndex[k] = curr->heapIndex[k];
+                r.serviceRank = serviceRank[curr->process_id];
+                r.deadline = curr->deadline;
+                r.mailboxCapacity = mailbox ? (uint32_t)mailbox->ring.capacity() : 0;
+                r.state = curr->state;
+                r.waiting = mailbox && mailbox->waiting;
+                memset(r.reserved, 0, sizeof(r.reserved));
+                records.push_back(r);
+            }
+        }
+
+        vector<const VirtualMemory::AddressSpace *> owned;
+        memory.forEachSpace([&owned](const VirtualMemory::AddressSpace &space) { owned.push_back(&space); });
+        sort(owned.begin(), owned.end(), [](const VirtualMemory::AddressSpace *a, const VirtualMemory::AddressSpace *b) { return a->pid < b->pid; });
+        vector<SnapshotSpace> spaces;
+        vector<SnapshotMapping> mappings;
+        for (const VirtualMemory::AddressSpace *space : owned)
+        {
+            size_t first = mappings.size();
+            space->table.forEachMapping([&mappings](uint64_t vpn, int frame) { mappings.push_back(SnapshotMapping{vpn, frame, 0}); });
+            spaces.push_back(SnapshotSpace{space->pid, 0, space->pageLimit, mappings.size() - first});
+        }
+        header.spaceCount = spaces.size();
+        header.mappingCount = mappings.size();
+        vector<SnapshotTlbSlot> tlbSlots;
+        memory.tlbState().forEachSlot([&tlbSlots](uint64_t tag, int frame, uint32_t lastUse) { tlbSlots.push_back(SnapshotTlbSlot{tag, frame, lastUse}); });
+
+        vector<SnapshotMessage> messages;
+        string payloads;
+        for (size_t pid = 0; pid < mailboxes.size(); pid++)
+            if (mailboxes[pid])
+                mailboxes[pid]->ring.forEach([&messages, &payloads, pid](const Message &message) {
+                    messages.push_back(SnapshotMessage{(int32_t)pid, message.sender, message.payload.size()});
+                    payloads += message.payload;
+                });
+        header.messageCount = messages.size();
+        header.payloadBytes = payloads.size();
+
+        ofstream file(path.c_str(), ios::binary | ios::trunc);
+        if (!file)
+            return false;
+        bytesWritten = 0;
+        auto writeSection = [&file, &bytesWritten](const void *data, size_t length) {
+            static const char padding[8] = {0};
+            file.write((const char *)data, length);
+            file.write(padding, snapshotAlign(length) - length);
+            bytesWritten += snapshotAlign(length);
+        };
+        writeSection(&header, sizeof(header));
+        writeSection(records.data(), records.size() * sizeof(SnapshotProcess));
+        writeSection(spaces.data(), spaces.size() * sizeof(SnapshotSpace));
+        writeSection(mappings.data(), mappings.size() * sizeof(SnapshotMapping));
+        writeSection(memory.referenceBits().data(), memory.referenceBits().size());
+        writeSection(tlbSlots.data(), tlbSlots.size() * sizeof(SnapshotTlbSlot));
+        writeSection(messages.data(), messages.size() * sizeof(SnapshotMessage));
+        writeSection(payloads.data(), payloads.size());
+        file.close();
+        if (!file)
+            return false;
+        logAction("Saved snapshot of " + to_string(records.size()) + " processes to " + path);
+        return true;
+    }
+
+    // Replace the whole manager state with a snapshot written by saveSnapshot.
+    // The file is mapped and checked in full before anything is changed, so a
+    // rejected file (reason in error) leaves the current state as it was.
+    bool restoreSnapshot(const string &path, string &error)
+    {
+        SnapshotImage image;
+        if (!image.open(path))
+        {
+            error = "unable to read snapshot " + path;
+            return false;
+        }
+        if (image.size() < sizeof(SnapshotHeader) || memcmp(image.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+        {
+            error = path + " is not a snapshot";
+            return false;
+        }
+        const SnapshotHeader &header = *(const SnapshotHeader *)image.data();
+        if (header.endianTag != SNAPSHOT_ENDIAN_TAG || header.version != SNAPSHOT_VERSION || header.headerSize != sizeof(SnapshotHeader) ||
+            header.processRecordSize != sizeof(SnapshotProcess))
+        {
+            error = "unsupported snapshot version " + to_string(header.version) + " in " + path;
+            return false;
+        }
+
+        // Locate the sections; counts are checked against the file size before they are multiplied
+        uint64_t offset = snapshotAlign(sizeof(SnapshotHeader));
+        bool fits = true;
+        auto section = [&image, &offset, &fits](uint64_t count, size_t elementSize) -> const char * {
+            const char *at = image.data() + min<uint64_t>(offset, image.size());
+            if (!fits || count > (image.size() - min<uint64_t>(offset, image.size())) / elementSize)
+                fits = false;
+            else
+                offset = snapshotAlign(offset + count * elementSize);
+            return at;
+        };
+        uint64_t readyCount = header.queueLength[0], runningCount = header.queueLength[1], blockedCount = header.queueLength[2];
+        uint64_t total = readyCount + runningCount + blockedCount;
+        if (readyCount > image.size() || runningCount > image.size() || blockedCount > image.size() || header.vmFrames <= 0)
+            fits = false;
+        const SnapshotProcess *records = (const SnapshotProcess *)section(total, sizeof(SnapshotProcess));
+        const SnapshotSpace *spaces = (const SnapshotSpace *)section(header.spaceCount, sizeof(SnapshotSpace));
+        const SnapshotMapping *mappings = (const SnapshotMapping *)section(header.mappingCount, sizeof(SnapshotMapping));
+        const uint8_t *referenced = (const uint8_t *)section(header.vmFrames, 1);
+        uint64_t tlbSlotCount = header.vmTlbSets > 0 && header.vmTlbWays > 0 ? (uint64_t)header.vmTlbSets * header.vmTlbWays : 0;
+        const SnapshotTlbSlot *tlbSlots = (const SnapshotTlbSlot *)section(tlbSlotCount, sizeof(SnapshotTlbSlot));
+        const SnapshotMessage *messages = (const SnapshotMessage *)section(header.messageCount, sizeof(SnapshotMessage));
+        const char *payloads = section(header.payloadBytes, 1);
+        if (!fits || offset != image.size())
+        {
+            error = "truncated or corrupt snapshot " + path;
+            return false;
+        }
+        error = "corrupt snapshot " + path;
+        if (header.processCounter < 0 || header.timeQuantum <= 0 || header.feedbackLevels <= 0 || header.feedbackLevels > 16 ||
+            header.feedbackBaseQuantum <= 0 || header.boostInterval < 0 || header.mailboxCapacity == 0 || header.mailboxCapacity > MAX_MAILBOX_CAPACITY ||
+            header.frameSize <= 0 || (header.preemptivePolicy != POLICY_SRTF && header.preemptivePolicy != POLICY_EDF && header.preemptivePolicy != POLICY_COUNT) ||
+            header.cpuHolder < 0)
+            return false;
+
+        // Every PID once, in a queue its state allows. Ready processes hold
+        // every heap position and service rank exactly once (the SRTF and EDF
+        // heaps only in preemptive mode); the heap order itself is trusted.
+        bool preemptive = header.preemptivePolicy != POLICY_COUNT;
+        int maxPid = 0;
+        for (uint64_t i = 0; i < total; i++)
+            maxPid = max(maxPid, (int)records[i].pid);
+        if (maxPid > header.processCounter)
+            return false;
+        vector<uint8_t> seen((size_t)maxPid + 1, 0), taken(readyCount, 0);
+        for (uint64_t i = 0; i < total; i++)
+        {
+            const SnapshotProcess &r = records[i];
+            int queue = i < readyCount ? 0 : i < readyCount + runningCount ? 1 : 2;
+            bool stateFits = queue == 0 ? (r.state == STATE_READY || r.state == STATE_SUSPENDED) : r.state == (queue == 1 ? STATE_RUNNING : STATE_BLOCKED);
+            bool mailboxFits = r.mailboxCapacity ? r.mailboxCapacity <= (uint32_t)MAX_MAILBOX_CAPACITY : !r.waiting;
+            if (r.pid <= 0 || seen[r.pid] || !stateFits || r.mlfqLevel < 0 || r.mlfqLevel >= header.feedbackLevels || !mailboxFits)
+                return false;
+            seen[r.pid] = 1;
+            int32_t positions[READY_HEAP_COUNT + 1];
+            memcpy(positions, r.heapIndex, sizeof(r.heapIndex));
+            positions[READY_HEAP_COUNT] = r.serviceRank;
+            for (int k = 0; k <= READY_HEAP_COUNT; k++)
+            {
+                bool held = queue == 0 && (preemptive || (k != SRTF_HEAP && k != EDF_HEAP));
+                if (!held ? positions[k] != -1 : positions[k] < 0 || (uint64_t)positions[k] >= readyCount || (taken[positions[k]] & (1 << k)))
+                    return false;
+                else if (held)
+                    taken[positions[k]] |= 1 << k;
+            }
+        }
+
+        // Rebuild memory and mailboxes aside; they are swapped in once everything checks out
+        VirtualMemory restoredMemory;
+        if (!restoredMemory.configure(header.vmFrames, header.vmPageSize, header.vmTlbSets, header.vmTlbWays, header.vmAddressBits))
+            return false;
+        const SnapshotMapping *mapping = mappings;
+        for (uint64_t i = 0; i < header.spaceCount; i++)
+        {
+            const SnapshotSpace &saved = spaces[i];
+            if (saved.pid <= 0 || saved.pid > maxPid || !seen[saved.pid] || restoredMemory.space(saved.pid) || saved.pageLimit == 0 ||
+                saved.mappings > (uint64_t)(mappings + header.mappingCount - mapping))
+                return false;
+            VirtualMemory::AddressSpace *space = restoredMemory.createSpace(saved.pid, saved.pageLimit * (uint64_t)restoredMemory.pageSize());
+            if (!space || space->pageLimit != saved.pageLimit)
+                return false;
+            for (uint64_t m = 0; m < saved.mappings; m++, mapping++)
+                if (!restoredMemory.restoreMapping(*space, mapping->vpn, mapping->frame))
+                    return false;
+        }
+        if (mapping != mappings + header.mappingCount)
+            return false;
+        restoredMemory.restoreClock(header.vmClockHand, referenced);
+        if (tlbSlotCount != restoredMemory.tlbState().slots())
+            return false;
+        for (uint64_t i = 0; i < tlbSlotCount; i++)
+            if (!restoredMemory.restoreTlbSlot(i, tlbSlots[i].tag, tlbSlots[i].frame, tlbSlots[i].lastUse))
+                return false;
+        restoredMemory.restoreTlbClock(header.vmTlbClock);
+        VmStats vm;
+        vm.accesses = header.vmCounters[0];
+        vm.tlbHits = header.vmCounters[1];
+        vm.tlbMisses = header.vmCounters[2];
+        vm.pageFaults = header.vmCounters[3];
+        vm.evictions = header.vmCounters[4];
+        vm.invalid = header.vmCounters[5];
+        restoredMemory.restoreCounters(vm);
+
+        vector<unique_ptr<Mailbox>> restoredMailboxes((size_t)maxPid + 1);
+        for (uint64_t i = 0; i < total; i++)
+            if (records[i].mailboxCapacity)
+            {
+                restoredMailboxes[records[i].pid].reset(new Mailbox(records[i].mailboxCapacity));
+                restoredMailboxes[records[i].pid]->waiting = records[i].waiting != 0;
+            }
+        uint64_t payloadOffset = 0;
+        for (uint64_t i = 0; i < header.messageCount; i++)
+        {
+            const SnapshotMessage &saved = messages[i];
+            if (saved.receiver <= 0 || saved.receiver > maxPid || !restoredMailboxes[saved.receiver] ||
+                saved.length > header.payloadBytes - payloadOffset)
+                return false;
+            Message message;
+            message.sender = saved.sender;
+            message.payload.assign(payloads + payloadOffset, (size_t)saved.length);
+            payloadOffset += saved.length;
+            if (!restoredMailboxes[saved.receiver]->ring.push(message))
+                return false;
+        }
+        if (payloadOffset != header.payloadBytes)
+            return false;
+        error.clear();
+
+        destroyAllProcesses();
+        processCounter = header.processCounter;
+        timeQuantum = header.timeQuantum;
+        adaptiveQuantum = header.adaptiveQuantum != 0;
+        configureFeedbackQueue(header.feedbackLevels, header.feedbackBaseQuantum, header.boostInterval);
+        feedbackClock = header.feedbackClock;
+        nextBoost = header.nextBoost;
+        strideGlobalPass = header.strideGlobalPass;
+        preemptivePolicy = (SchedulingPolicy)header.preemptivePolicy;
+        cpuHolder = header.cpuHolder;
+        preemptions = header.preemptions;
+        remainingKeysStale = false;
+        generator.restore(header.rngState, header.arrivalClock);
+        mailboxCapacity = (size_t)header.mailboxCapacity;
+        frameSize = header.frameSize;
+        memory = move(restoredMemory);
+        mailboxes.swap(restoredMailboxes);
+
+        processTable.reserve((int)total, maxPid);
+        fcfsHeap.reserve(readyCount);
+        priorityHeap.reserve(readyCount);
+        sjfHeap.reserve(readyCount);
+        fcfsHeap.restoreSize(readyCount);
+        priorityHeap.restoreSize(readyCount);
+        sjfHeap.restoreSize(readyCount);
+        srtfHeap.restoreSize(preemptive ? readyCount : 0);
+        edfHeap.restoreSize(preemptive ? readyCount : 0);
+        long long firstTicket = feedbackTickets;
+        feedbackTickets += readyCount;
+        vector<FeedbackEntry> serviceOrder(readyCount);
+        vector<uint8_t> serviceLevel(readyCount);
+        ProcessQueue *queues[] = {&readyQueue, &runningQueue, &blockedQueue};
+        for (uint64_t i = 0; i < total; i++)
+        {
+            const SnapshotProcess &r = records[i];
+            Process *process = processTable.allocate(r.pid);
+            process->AT = r.AT;
+            process->BT = r.BT;
+            process->remainingBT = r.remainingBT;
+            process->priority = r.priority;
+            process->page_size = r.pageSize;
+            process->memory_allocated = r.memoryAllocated;
+            process->process_size = r.processSize;
+            process->state = (ProcessState)r.state;
+            process->mlfqLevel = r.mlfqLevel;
+            process->cpuAffinity = r.cpuAffinity;
+            process->stridePass = r.stridePass;
+            process->deadline = r.deadline;
+            queues[i < readyCount ? 0 : i < readyCount + runningCount ? 1 : 2]->pushBack(process);
+            if (i < readyCount)
+            {
+                fcfsHeap.restore(r.heapIndex[FCFS_HEAP], process);
+                priorityHeap.restore(r.heapIndex[PRIORITY_HEAP], process);
+                sjfHeap.restore(r.heapIndex[SJF_HEAP], process);
+                if (preemptive)
+                {
+                    srtfHeap.restore(r.heapIndex[SRTF_HEAP], process);
+                    edfHeap.restore(r.heapIndex[EDF_HEAP], process);
+                }
+                process->mlfqTicket = firstTicket + r.serviceRank;
+                serviceOrder[r.serviceRank] = FeedbackEntry{process, process->mlfqTicket};
+                serviceLevel[r.serviceRank] = (uint8_t)r.mlfqLevel;
+            }
+        }
+        for (uint64_t i = 0; i < readyCount; i++)
+            feedbackLevels[serviceLevel[i]].push(serviceOrder[i]);
+        feedbackEntries = readyCount;
+        for (ProcessQueue *queue : queues)
+            publishQueueLength(*queue);
+        logAction("Restored snapshot of " + to_string(total) + " processes from " + path);
+        return true;
+    }
+
+    // Automatically create multiple processes with random values
+    void createMultipleProcesses(int numProcesses)
+    {
+        generateWorkload(WorkloadSpec(), numProcesses);
+    }
+
+    // Destroy a process
+    bool destroyProcess(int pid)
+    {
+        Process *process = findProcess(readyQueue, pid);
+        if (process)
+        {
+            if (trace)
+                trace->record(TRACE_DESTROY, pid, traceClock++);
+            deleteProcess(readyQueue, process);
+            if (logEnabled(LOG_INFO))
+                logAction("Destroyed Process " + to_string(pid));
+            return true;
+        }
+        else
+        {
+            console() << "Process ID " << pid << " not found." << endl;
+            return false;
+        }
+    }
+
+    // Change process priority
+    bool changeProcessPriority(int pid, int newPriority)
+    {
+        Process *process = findProcess(readyQueue, pid);
+        if (process)
+        {
+            if (trace)
+                trace->record(TRACE_PRIORITY, pid, traceClock++, process->priority, newPriority);
+            process->priority = newPriority;
+            priorityHeap.update(process);
+            logAction("Changed priority of Process " + to_string(pid) + " to " + to_string(newPriority));
+            console() << "Priority of process " << pid << " has been changed to " << newPriority << endl;
+            return true;
+        }
+        else
+        {
+            console() << "Process ID " << pid << " not found." << endl;
+            return false;
+        }
+    }
+
+    // Pin a process to one CPU of the multi-core simulation (-1 = any CPU)
+    bool setProcessAffinity(int pid, int cpu)
+    {
+        if (cpu < -1)
+        {
+            console() << "Invalid CPU " << cpu << " (use -1 for any CPU)." << endl;
+            return false;
+        }
+        Process *process = processTable.lookup(pid);
+        if (!process)
+        {
+            console() << "Process ID " << pid << " not found." << endl;
+            return false;
+        }
+        process->cpuAffinity = cpu;
+        logAction("Set CPU affinity of Process " + to_string(pid) + " to " + (cpu < 0 ? string("any CPU") : "CPU " + to_string(cpu)));
+        return true;
+    }
+
+    // Process communication simulation
+    SendStatus processCommunication(int senderPid, int receiverPid, const string &message)
+    {
+        string payload = message;
+        SendStatus status = sendMessage(senderPid, receiverPid, payload);
+        if (status == SEND_NOT_FOUND)
+            console() << "Sender must be ready or running and the receiver must exist." << endl;
+        else if (status == SEND_FULL)
+            console() << "Mailbox of Process " << receiverPid << " is full (" << mailboxes[receiverPid]->ring.capacity() << " messages)." << endl;
+        else
+        {
+            logAction("Process " + to_string(senderPid) + " sent a message to Process " + to_string(receiverPid) + ": " + message);
+            console() << "Process " << senderPid << " sent a message to Process " << receiverPid << ": " << message << endl;
+            if (status == SEND_WOKE)
+                console() << "Process " << receiverPid << " was waiting and has been woken up." << endl;
+        }
+        return status;
+    }
+
+    // Capacity of mailboxes created from now on
+    bool setMailboxCapacity(int capacity)
+    {
+        if (capacity <= 0 || capacity > MAX_MAILBOX_CAPACITY)
+        {
+            console() << "Mailbox capacity must be between 1 and " << to_string(MAX_MAILBOX_CAPACITY) << "." << endl;
+            return false;
+        }
+        mailboxCapacity = capacity;
+        logAction("Set mailbox capacity to " + to_string(capacity) + " messages.");
+        return true;
+    }
+
+    // Queue payload in the receiver's mailbox. The payload buffer is moved,
+    // and payload comes back holding a recycled buffer. The sender must be
+    // ready or running; a receiver blocked in receive is woken.
+    SendStatus sendMessage(int senderPid, int receiverPid, string &payload)
+    {
+        Process *sender = processTable.lookup(senderPid);
+        Process *receiver = processTable.lookup(receiverPid);
+        if (!sender || !receiver || (sender->queue != &readyQueue && sender->queue != &runningQueue))
+            return SEND_NOT_FOUND;
+        if (receiverPid >= (int)mailboxes.size())
+            mailboxes.resize(max((size_t)receiverPid + 1, mailboxes.size() * 2));
+        unique_ptr<Mailbox> &mailbox = mailboxes[receiverPid];
+        if (!mailbox)
+            mailbox.reset(new Mailbox(mailboxCapacity));
+        Message message;
+        message.sender = senderPid;
+        message.payload.swap(payload);
+        if (!mailbox->ring.push(message))
+        {
+            payload.swap(message.payload);
+            return SEND_FULL;
+        }
+        payload.swap(message.payload);
+        Instrumentation::add(COUNTER_MESSAGE_SENT);
+        if (logEnabled(LOG_DEBUG))
+            logAction("Process " + to_string(senderPid) + " queued a message for Process " + to_string(receiverPid), LOG_DEBUG);
+        if (!mailbox->waiting)
+            return SEND_OK;
+        mailbox->waiting = false;
+        if (receiver->queue != &blockedQueue)
+            return SEND_OK;
+        moveProcess(blockedQueue, readyQueue, receiverPid, STATE_READY, TRACE_WAKEUP);
+        return SEND_WOKE;
+    }
+
+    // Take the oldest message for a ready or running process, swapping its
+    // buffer into message. With an empty mailbox the process blocks until a
+    // message is sent to it.
+    ReceiveStatus receiveMessage(int pid, Message &message)
+    {
+        Process *process = processTable.lookup(pid);
+        if (!process || (process->queue != &readyQueue && process->queue != &runningQueue))
+            return RECEIVE_NOT_FOUND;
+        Mailbox *mailbox = pid < (int)mailboxes.size() ? mailboxes[pid].get() : nullptr;
+        if (mailbox && mailbox->ring.pop(message))
+        {
+            Instrumentation::add(COUNTER_MESSAGE_RECEIVED);
+            return RECEIVE_OK;
+        }
+        if (!mailbox)
+        {
+            if (pid >= (int)mailboxes.size())
+                mailboxes.resize(max((size_t)pid + 1, mailboxes.size() * 2));
+            mailboxes[pid].reset(new Mailbox(mailboxCapacity));
+            mailbox = mailboxes[pid].get();
+        }
+        mailbox->waiting = true;
+        Instrumentation::add(COUNTER_RECEIVE_BLOCK);
+        moveProcess(*process->queue, blockedQueue, pid, STATE_BLOCKED, TRACE_BLOCK);
+        return RECEIVE_BLOCKED;
+    }
+
+    // Messages waiting in a process's mailbox
+    size_t pendingMessages(int pid) const
+    {
+        return pid >= 0 && pid < (int)mailboxes.size() && mailboxes[pid] ? mailboxes[pid]->ring.size() : 0;
+    }
+
+    // Pass count messages of payloadBytes around a ring of processes fresh
+    // processes. Every other message is received by a process that is already
+    // waiting, so the blocking receive and the waking send are exercised too.
+    // The timed loop runs at LOG_WARN or above, so it measures the mailbox
+    // path rather than per-message records. The processes are destroyed
+    // afterwards; returns the messages delivered.
+    long long runMessageWorkload(int processes, long long count, int payloadBytes, double &seconds)
+    {
+        processes = max(processes, 2);
+        vector<int> pids(processes);
+        for (int i = 0; i < processes; i++)
+            pids[i] = createProcess(0, 1, 0);
+        string payload(max(payloadBytes, 0), 'x');
+        Message message;
+        long long delivered = 0;
+        LogLevel previousLevel = logger.getLevel();
+        logger.setLevel(max(previousLevel, LOG_WARN));
+        chrono::steady_clock::time_point started = chrono::steady_clock::now();
+        for (long long i = 0; i < count; i++)
+        {
+            int receiver = pids[i % processes];
+            int sender = pids[(i + 1) % processes];
+            if (i & 1)
+                receiveMessage(receiver, message); // Blocks: the mailbox is empty
+            sendMessage(sender, receiver, payload);
+            if (receiveMessage(receiver, message) == RECEIVE_OK)
+            {
+                delivered++;
+                payload.swap(message.payload); // Reuse the buffer for the next send
+            }
+        }
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        logger.setLevel(previousLevel);
+        for (int pid : pids)
+            destroyProcess(pid);
+        logAction("Passed " + to_string(delivered) + " messages between " + to_string(processes) + " processes.");
+        return delivered;
+    }
+
+    // Suspend a process
+    bool suspendProcess(int pid)
+    {
+        return moveProcess(runningQueue, readyQueue, pid, STATE_SUSPENDED, TRACE_SUSPEND);
+    }
+
+    // Resume a process
+    bool resumeProcess()
+    {
+        if (readyQueue.head)
+        {
+            Process *toResume = readyQueue.head; // Assume the first found process to be resumed
+            return moveProcess(readyQueue, runningQueue, toResume->process_id, STATE_RUNNING, TRACE_DISPATCH);
+        }
+        return false;
+    }
+
+    // Block a process
+    bool blockProcess(int pid)
+    {
+        return moveProcess(runningQueue, blockedQueue, pid, STATE_BLOCKED, TRACE_BLOCK);
+    }
+
+    // Wake up a process
+    bool wakeupProcess()
+    {
+        if (blockedQueue.head)
+        {
+            Process *toWakeup = blockedQueue.head; // Assume the first found process to be woken up
+            return moveProcess(blockedQueue, readyQueue, toWakeup->process_id, STATE_READY, TRACE_WAKEUP);
+        }
+        return false;
+    }
+
+    // Dispatch a process
+    bool dispatchProcess(int pid)
+    {
+        return moveProcess(readyQueue, runningQueue, pid, STATE_RUNNING, TRACE_DISPATCH);
+    }
+
+    // First-Come-First-Serve (FCFS) scheduling
+    void fcfs(bool drainAll = false)
+    {
+        exitPreemptiveMode();
+        dispatchFrom(fcfsHeap, drainAll, POLICY_FCFS);
+    }
+
+    // Priority Scheduling
+    void priorityScheduling(bool drainAll = false)
+    {
+        exitPreemptiveMode();
+        dispatchFrom(priorityHeap, drainAll, POLICY_PRIORITY);
+    }
+
+    // Lottery scheduling. Each ready process holds ticketsFor(priority)
+    // tickets in a Fenwick tree built in O(n), and each draw picks one ticket
+    // uniformly in O(log n). The winner runs one quantum, and a process that
+    // needs no more than that is dispatched. Draws once per ready process, or
+    // until the queue is empty when drainAll is set; returns the fairness error.
+    double lotteryScheduling(bool drainAll = false)
+    {
+        ScopedTimer timer(TIMER_SCHEDULING);
+        exitPreemptiveMode();
+        vector<Process *> ready;
+        vector<long long> weights;
+        vector<int> priorities;
+        ready.reserve(readyQueue.size);
+        for (Process *curr = readyQueue.head; curr; curr = curr->next)
+        {
+            ready.push_back(curr);
+            weights.push_back(ticketsFor(curr->priority));
+            priorities.push_back(curr->priority);
+        }
+        FenwickTree tickets;
+        tickets.assign(weights);
+        ShareLedger shares(priorities);
+        for (size_t i = 0; i < ready.size(); i++)
+            shares.join((int)i);
+
+        Xoshiro256 &rng = generator.engine();
+        int slices = 0, dispatched = 0;
+        for (long long draws = drainAll ? LLONG_MAX : (long long)ready.size(); draws > 0 && tickets.total() > 0; draws--)
+        {
+            size_t i = tickets.find((long long)(rng() % (uint64_t)tickets.total()));
+            slices++;
+            if (runShareSlice(ready[i], (int)i, shares))
+            {
+                tickets.add(i, -weights[i]);
+                dispatched++;
+            }
+        }
+        return reportShares(POLICY_LOTTERY, shares, slices, dispatched);
+    }
+
+    // Stride scheduling. A process's pass grows by strideFor(priority) for
+    // each full quantum it runs (pro rata for a shorter last slice) and is
+    // kept between calls; the lowest pass runs next, from a min-heap built in
+    // O(n) with ties going to the lower PID. A process that was not ready
+    // rejoins at the global pass, so it cannot bank credit. Picks once per
+    // ready process, or until the queue is empty when drainAll is set; returns
+    // the fairness error.
+    double strideScheduling(bool drainAll = false)
+    {
+        struct Entry
+        {
+            long long pass;
+            int pid;
+            int item;
+        };
+        struct After
+        {
+            bool operator()(const Entry &a, const Entry &b) const
+            {
+                if (a.pass != b.pass)
+                    return a.pass > b.pass;
+                return a.pid > b.pid;
+            }
+        };
+
+        ScopedTimer timer(TIMER_SCHEDULING);
+        exitPreemptiveMode();
+        vector<Process *> ready;
+        vector<int> priorities;
+        vector<Entry> heap;
+        ready.reserve(readyQueue.size);
+        for (Process *curr = readyQueue.head; curr; curr = curr->next)
+        {
+            curr->stridePass = max(curr->stridePass, strideGlobalPass);
+            heap.push_back(Entry{curr->stridePass, curr->process_id, (int)ready.size()});
+            ready.push_back(curr);
+            priorities.push_back(curr->priority);
+        }
+        make_heap(heap.begin(), heap.end(), After());
+        ShareLedger shares(priorities);
+        for (size_t i = 0; i < ready.size(); i++)
+            shares.join((int)i);
+
+        int slices = 0, dispatched = 0;
+        for (long long picks = drainAll ? LLONG_MAX : (long long)ready.size(); picks > 0 && !heap.empty(); picks--)
+        {
+            pop_heap(heap.begin(), heap.end(), After());
+            Entry entry = heap.back();
+            heap.pop_back();
+            Process *process = ready[entry.item];
+            strideGlobalPass = entry.pass;
+            process->stridePass += strideFor(process->priority) * min(timeQuantum, process->remainingBT) / timeQuantum;
+            slices++;
+            if (runShareSlice(process, entry.item, shares))
+            {
+                dispatched++;
+                continue;
+            }
+            heap.push_back(Entry{process->stridePass, entry.pid, entry.item});
+            push_heap(heap.begin(), heap.end(), After());
+        }
+        return reportShares(POLICY_STRIDE, shares, slices, dispatched);
+    }
+
+    // Shortest Job First (SJF) scheduling
+    void sjf(bool drainAll = false)
+    {
+        exitPreemptiveMode();
+        dispatchFrom(sjfHeap, drainAll, POLICY_SJF);
+    }
+
+    // Shortest Remaining Time First (SRTF) scheduling. Dispatches the ready
+    // process with the least remaining burst (every one in that order when
+    // drainAll is set). The last one dispatched holds the CPU, and a process
+    // with less remaining that later enters the ready queue preempts it.
+    void srtf(bool drainAll = false)
+    {
+        enterPreemptiveMode(POLICY_SRTF);
+        settleRemainingKeys();
+        cpuHolder = dispatchFrom(srtfHeap, drainAll, POLICY_SRTF);
+    }
+
+    // Earliest Deadline First (EDF) scheduling; as srtf(), ranked by deadline
+    // with processes that have none last
+    void edf(bool drainAll = false)
+    {
+        enterPreemptiveMode(POLICY_EDF);
+        cpuHolder = dispatchFrom(edfHeap, drainAll, POLICY_EDF);
+    }
+
+    // Preemptions since startup, and the process holding the CPU in preemptive mode
+    long long preemptionCount() const { return preemptions; }
+    int preemptiveHolder() const { return preemptiveMode() ? cpuHolder : 0; }
+
+    // Set the Round-Robin quantum; 0 selects the adaptive quantum
+    bool setTimeQuantum(int quantum)
+    {
+        if (quantum < 0)
+        {
+            console() << "Time quantum must not be negative." << endl;
+            return false;
+        }
+        adaptiveQuantum = quantum == 0;
+        if (quantum > 0)
+            timeQuantum = quantum;
+        logAction("Set Round-Robin time quantum to " + quantumName(quantum) + ".");
+        return true;
+    }
+
+    // Current Round-Robin quantum (0 when adaptive)
+    int getTimeQuantum() const { return adaptiveQuantum ? 0 : timeQuantum; }
+
+    // Round-Robin (RR) scheduling
+    void roundRobin()
+    {
+        ScopedTimer timer(TIMER_SCHEDULING);
+        exitPreemptiveMode();
+        roundRobinLevel(INT_MIN, INT_MAX, POLICY_RR);
+    }
+
+    // Multilevel Queue Scheduling
+    void multilevelQueueScheduling()
+    {
+        const int threshold = 5; // Arbitrary priority threshold
+        ScopedTimer timer(TIMER_SCHEDULING);
+        exitPreemptiveMode();
+
+        // High priority level - Use Priority Scheduling
+        Process *toRun = priorityHeap.top();
+        if (toRun && toRun->priority >= threshold)
+        {
+            dispatchProcess(toRun->process_id);
+            Instrumentation::add(COUNTER_DISPATCH + POLICY_MLQ);
+        }
+
+        // Low priority level - Use Round-Robin Scheduling
+        roundRobinLevel(INT_MIN, threshold - 1, POLICY_MLQ);
+    }
+
+    // Set up the Multilevel Feedback Queue: level i runs slices of
+    // baseQuantum << i, and every boostTicks charged ticks all ready processes
+    // return to level 0 (0 disables boosting)
+    bool configureFeedbackQueue(int levels, int baseQuantum, int boostTicks)
+    {
+        if (levels <= 0 || levels > 16 || baseQuantum <= 0 || boostTicks < 0)
+        {
+            console() << "Invalid feedback queue settings." << endl;
+            return false;
+        }
+        // Boosted queues are served first, so they lead the old levels
+        vector<CircularRunQueue<FeedbackEntry>> previous(boostedLevels.begin(), boostedLevels.end());
+        boostedLevels.clear();
+        previous.insert(previous.end(), feedbackLevels.begin(), feedbackLevels.end());
+        feedbackLevels.clear();
+        feedbackEntries = 0;
+        feedbackLevels.resize(levels);
+        feedbackQuanta.resize(levels);
+        for (int level = 0; level < levels; level++)
+            feedbackQuanta[level] = (int)min((long long)baseQuantum << level, (long long)INT_MAX);
+        boostInterval = boostTicks;
+        nextBoost = boostTicks ? feedbackClock + boostTicks : 0;
+        // Re-enter queued processes in service order, clamped to the new depth
+        for (size_t level = 0; level < previous.size(); level++)
+            while (!previous[level].empty())
+            {
+                FeedbackEntry entry = previous[level].pop();
+                if (entry.process->queue == &readyQueue && entry.process->mlfqTicket == entry.ticket)
+                {
+                    settleBoost(entry.process);
+                    enterFeedbackLevel(entry.process);
+                }
+            }
+        logAction("Configured feedback queue: " + to_string(levels) + " levels, base quantum " + to_string(baseQuantum) + ", boost every " + to_string(boostTicks) + " ticks.");
+        return true;
+    }
+
+    int feedbackLevelCount() const { return (int)feedbackLevels.size(); }
+    int feedbackBaseQuantum() const { return feedbackQuanta[0]; }
+    int feedbackBoostInterval() const { return boostInterval; }
+
+    // Multilevel Feedback Queue scheduling. The highest non-empty level is
+    // served first; a process that needs more than its level's quantum is
+    // charged a slice and demoted one level, otherwise it is dispatched.
+    // Stops after the first dispatch unless drainAll is set.
+    void multilevelFeedbackScheduling(bool drainAll = false)
+    {
+        ScopedTimer timer(TIMER_SCHEDULING);
+        exitPreemptiveMode();
+        int slices = 0, demoted = 0, dispatched = 0;
+        while (readyQueue.size > 0)
+        {
+            if (boostInterval > 0 && feedbackClock >= nextBoost)
+            {
+                boostFeedbackLevels();
+                nextBoost = feedbackClock + boostInterval;
+                logAction("Boosted all ready processes to the top feedback level.", LOG_DEBUG);
+            }
+            Process *process = nextFeedbackProcess();
+            if (!process)
+                break;
+            int level = process->mlfqLevel;
+            slices++;
+            if (process->remainingBT <= feedbackQuanta[level])
+            {
+                feedbackClock += process->remainingBT;
+                dispatchProcess(process->process_id);
+                dispatched++;
+                if (!drainAll)
+                    break;
+                continue;
+            }
+            process->remainingBT -= feedbackQuanta[level];
+            remainingKeysStale = true;
+            feedbackClock += feedbackQuanta[level];
+            if (level + 1 < (int)feedbackLevels.size())
+            {
+                process->mlfqLevel = level + 1;
+                demoted++;
+            }
+            enterFeedbackLevel(process);
+        }
+        Instrumentation::add(COUNTER_DISPATCH + POLICY_MLFQ, dispatched);
+        if (slices > 0)
+            logAction("Feedback queue pass: " + to_string(slices) + " slices, " + to_string(demoted) + " demotions, " + to_string(dispatched) + " dispatched.");
+    }
+
+    // Simulation settings matching the live scheduler configuration
+    SimulationOptions simulationOptions(SchedulingPolicy policy) const
+    {
+        SimulationOptions options(policy);
+        if (policy == POLICY_MLFQ)
+            options.timeQuantum = feedbackQuanta[0];
+        else
+            options.setQuantum(getTimeQuantum());
+        options.mlfqLevels = (int)feedbackLevels.size();
+        options.boostInterval = boostInterval;
+        return options;
+    }
+
+    // Perform Paging
+    bool performPaging(int pid)
+    {
+        Process *process = findProcess(readyQueue, pid);
+        if (process)
+        {
+            int numPages = (process->process_size + frameSize - 1) / frameSize;
+            console() << "Process " << pid << " requires " << numPages << " pages." << endl;
+            VirtualMemory::AddressSpace *space = memory.createSpace(pid, process->process_size);
+            if (space)
+                console() << "Mapped " << space->pageLimit << " virtual pages behind a " << space->table.depth() << "-level page table; "
+                          << memory.freeFrames() << " of " << memory.frameCount() << " frames free." << endl;
+            logAction("Performed paging for Process " + to_string(pid) + ": " + to_string(numPages) + " pages required.");
+            return true;
+        }
+        else
+        {
+            console() << "Process ID " << pid << " not found." << endl;
+            return false;
+        }
+    }
+
+    // Reconfigure the virtual memory model; all address spaces are dropped
+    bool configureMemory(int frames, int pageSize, int tlbSets, int tlbWays, int addressBits)
+    {
+        if (!memory.configure(frames, pageSize, tlbSets, tlbWays, addressBits))
+        {
+            console() << "Invalid memory settings (page size must be a power of two)." << endl;
+            return false;
+        }
+        frameSize = pageSize;
+        logAction("Configured virtual memory: " + to_string(frames) + " frames of " + to_string(pageSize) + " bytes, " + to_string(memory.tlbSets()) + "x" +
+                  to_string(tlbWays) + " TLB, " + to_string(addressBits) + "-bit addresses.");
+        return true;
+    }
+
+    // Address space of a live process, created from its process_size on first use
+    VirtualMemory::AddressSpace *addressSpace(int pid)
+    {
+        VirtualMemory::AddressSpace *space = memory.space(pid);
+        if (!space)
+        {
+            Process *process = processTable.lookup(pid);
+            if (process)
+                space = memory.createSpace(pid, process->process_size);
+        }
+        if (!space)
+            console() << "Process ID " << pid << " not found." << endl;
+        return space;
+    }
+
+    // Translate one virtual address of a process; -1 if it is not found or out of range
+    long long translateAddress(int pid, uint64_t vaddr)
+    {
+        VirtualMemory::AddressSpace *space = addressSpace(pid);
+        if (!space)
+            return -1;
+        long long paddr = memory.translate(*space, vaddr);
+        if (paddr < 0)
+            console() << "Address " << vaddr << " is outside the address space of process " << pid << "." << endl;
+        else
+            console() << "Process " << pid << ": virtual " << vaddr << " -> physical " << paddr << endl;
+        return paddr;
+    }
+
+    // Issue count uniformly random accesses over the first pages pages of a
+    // process and return the counters of this run
+    VmStats runMemoryWorkload(int pid, long long count, uint64_t pages, uint64_t seed, double &seconds)
+    {
+        VmStats before = memory.counters();
+        VirtualMemory::AddressSpace *space = addressSpace(pid);
+        seconds = 0;
+        if (!space)
+            return VmStats();
+        uint64_t span = max<uint64_t>(1, min(pages, space->pageLimit)) * (uint64_t)memory.pageSize();
+        uint64_t state = seed * 0x9E3779B97F4A7C15ULL + 1;
+        chrono::steady_clock::time_point started = chrono::steady_clock::now();
+        for (long long i = 0; i < count; i++)
+        {
+            // xorshift64*
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            memory.translate(*space, (state * 0x2545F4914F6CDD1DULL >> 16) % span);
+        }
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        return reportMemoryRun(pid, before, seconds);
+    }
+
+    // Replay a page trace (page numbers) as accesses to the start of each page
+    VmStats runMemoryTrace(int pid, const string &path, double &seconds)
+    {
+        VmStats before = memory.counters();
+        VirtualMemory::AddressSpace *space = addressSpace(pid);
+        seconds = 0;
+        PageTraceReader reader;
+        if (!space || !reader.open(path))
+        {
+            if (space)
+                console() << "Unable to open page trace " << path << "." << endl;
+            return VmStats();
+        }
+        vector<int> batch(1 << 16);
+        chrono::steady_clock::time_point started = chrono::steady_clock::now();
+        for (size_t n; (n = reader.next(batch.data(), batch.size())) > 0;)
+            for (size_t i = 0; i < n; i++)
+                memory.translate(*space, (uint64_t)(unsigned)batch[i] * memory.pageSize());
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        return reportMemoryRun(pid, before, seconds);
+    }
+
+    // Counters accumulated since the last reset
+    const VmStats &memoryCounters() const { return memory.counters(); }
+    const VirtualMemory &virtualMemory() const { return memory; }
+
+    // Perform LRU page replacement simulation
+    ReplacementResult performLRU(int numFrames, const vector<int> &pageReferences)
+    {
+        if (numFrames <= 0)
+        {
+            console() << "Number of frames must be positive." << endl;
+            return ReplacementResult();
+        }
+        ReplacementResult result = runReplacement(REPLACEMENT_LRU, numFrames, pageReferences, true, trace.get());
+        reportLRU(numFrames, result);
+        return result;
+    }
+
+    // Perform LRU page replacement over a trace file, streamed in chunks
+    ReplacementResult performLRUFromTrace(int numFrames, const string &path)
+    {
+        ReplacementResult result;
+        if (numFrames <= 0)
+            console() << "Number of frames must be positive." << endl;
+        else if (!runReplacementTrace(REPLACEMENT_LRU, numFrames, path, result, trace.get()))
+            console() << "Unable to read page trace " << path << endl;
+        else
+            reportLRU(numFrames, result);
+        return result;
+    }
+
+    // Run every replacement algorithm over the same reference string and compare fault rates
+    vector<ReplacementResult> compareReplacementPolicies(int numFrames, const vector<int> &pageReferences)
+    {
+        vector<ReplacementResult> results;
+        if (numFrames <= 0)
+        {
+            console() << "Number of frames must be positive." << endl;
+            return results;
+        }
+        for (int a = 0; a < REPLACEMENT_COUNT; a++)
+            results.push_back(runReplacement((ReplacementAlgorithm)a, numFrames, pageReferences, false));
+        reportComparison(numFrames, results);
+        return results;
+    }
+
+    // Compare every replacement algorithm over a trace file, one streamed pass each
+    vector<ReplacementResult> compareReplacementPoliciesFromTrace(int numFrames, const string &path)
+    {
+        vector<ReplacementResult> results;
+        if (numFrames <= 0)
+        {
+            console() << "Number of frames must be positive." << endl;
+            return results;
+        }
+        for (int a = 0; a < REPLACEMENT_COUNT; a++)
+        {
+            ReplacementResult result;
+            if (!runReplacementTrace((ReplacementAlgorithm)a, numFrames, path, result))
+            {
+                console() << "Unable to read page trace " << path << endl;
+                return vector<ReplacementResult>();
+            }
+            results.push_back(result);
+        }
+        reportComparison(numFrames, results);
+        return results;
+    }
+
+    // Compute the LRU miss-ratio curve for 1..maxFrames frames in one pass,
+    // optionally sampled, and write it as CSV when a path is given
+    vector<MissRatioPoint> missRatioCurve(int maxFrames, const vector<int> &pageReferences, double samplingRate, const string &csvPath)
+    {
+        if (maxFrames <= 0)
+        {
+            console() << "Number of frames must be positive." << endl;
+            return vector<MissRatioPoint>();
+        }
+        StackDistanceAnalyzer analyzer(maxFrames, samplingRate);
+        for (size_t i = 0; i < pageReferences.size(); i++)
+            analyzer.access(pageReferences[i]);
+        return reportMissRatioCurve(analyzer, maxFrames, csvPath);
+    }
+
+    // Miss-ratio curve over a trace file, streamed in chunks
+    vector<MissRatioPoint> missRatioCurveFromTrace(int maxFrames, const string &path, double samplingRate, const string &csvPath)
+    {
+        if (maxFrames <= 0)
+        {
+            console() << "Number of frames must be positive." << endl;
+            return vector<MissRatioPoint>();
+        }
+        StackDistanceAnalyzer analyzer(maxFrames, samplingRate);
+        PageTraceReader reader;
+        vector<int> chunk(1 << 16);
+        size_t count;
+        bool opened = reader.open(path);
+        if (opened)
+            while ((count = reader.next(chunk.data(), chunk.size())) > 0)
+                for (size_t i = 0; i < count; i++)
+                    analyzer.access(chunk[i]);
+        if (!opened || reader.hasFailed())
+        {
+            console() << "Unable to read page trace " << path << endl;
+            return vector<MissRatioPoint>();
+        }
+        return reportMissRatioCurve(analyzer, maxFrames, csvPath);
+    }
+
+    // Set page size for a process
+    bool setPageSize(int pid, int pageSize)
+    {
+        Process *process = findProcess(readyQueue, pid);
+        if (process)
+        {
+            process->page_size = pageSize;
+            logAction("Page size of process " + to_string(pid) + " set to " + to_string(pageSize));
+            console() << "Page size of process " << pid << " has been set to " << pageSize << endl;
+            return true;
+        }
+        else
+        {
+            console() << "Process ID " << pid << " not found." << endl;
+            return false;
+        }
+    }
+
+    // Calculate number of pages required
+    bool calculatePages(int pid, int memoryAllocated, int processSize)
+    {
+        Process *process = findProcess(readyQueue, pid);
+        if (process)
+        {
+            process->memory_allocated = memoryAllocated;
+            process->process_size = processSize;
+
+            int pageSize = process->page_size > 0 ? process->page_size : frameSize; // Unset page size: use the frame size
+            int numberOfPages = process->memory_allocated / pageSize;
+            int numberOfFrames = process->process_size / pageSize;
+            int numberOfEntries = numberOfPages * numberOfFrames;
+
+            logAction("Calculated pages for process " + to_string(pid));
+            console() << "Memory needed for process " << pid << " is " << memoryAllocated << endl;
+            console() << "Number of pages in the process: " << numberOfPages << endl;
+            console() << "Number of frames in memory for process " << pid << " : " << numberOfFrames << endl;
+            console() << "Number of entries: " << numberOfEntries << endl;
+            return true;
+        }
+        else
+        {
+            console() << "Process ID " << pid << " not found." << endl;
+            return false;
+        }
+    }
+
+    // Run the current ready queue to completion in the discrete-event simulator
+    SimulationResult simulateScheduling(const SimulationOptions &options)
+    {
+        vector<SimJob> jobs = readyJobs();
+        SimulationOptions traced = options;
+        if (!traced.trace)
+            traced.trace = trace.get();
+        SimulationResult result = SchedulerSimulator::run(jobs, traced);
+        logAction("Simulated " + string(policyName(options.policy)) + " over " + to_string(jobs.size()) + " processes: avg turnaround " + to_string(result.avgTurnaround) + ", avg waiting " + to_string(result.avgWaiting));
+        return result;
+    }
+
+    // Snapshot of the ready queue as simulator jobs
+    vector<SimJob> readyJobs() const
+    {
+        vector<SimJob> jobs;
+        jobs.reserve(readyQueue.size);
+        for (Process *curr = readyQueue.head; curr; curr = curr->next)
+            jobs.push_back(SimJob{curr->process_id, curr->AT, curr->remainingBT, curr->remainingBT, curr->priority, -1, -1, curr->cpuAffinity, curr->deadline});
+        return jobs;
+    }
+
+    // Run a parameter sweep over the ready queue (or generated workloads) and a reference string
+    vector<SweepRow> sweep(const SweepGrid &grid, const vector<int> &pageReferences, const string &tracePath)
+    {
+        chrono::steady_clock::time_point started = chrono::steady_clock::now();
+        vector<SweepRow> rows = runSweep(grid, readyJobs(), pageReferences, tracePath);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        logAction("Ran sweep of " + to_string(rows.size()) + " configurations on " + to_string(grid.threads) + " threads in " + to_string(seconds) + " s.");
+        return rows;
+    }
+
+    // Ready and suspended processes as columns, in ready-queue order
+    ProcessColumns readyColumns() const
+    {
+        ProcessColumns columns;
+        columns.reserve(readyQueue.size);
+        for (Process *curr = readyQueue.head; curr; curr = curr->next)
+            columns.add(curr->process_id, curr->AT, curr->BT, curr->remainingBT, curr->priority, curr->state);
+        return columns;
+    }
+
+    // Run the ready queue to completion on several simulated CPUs
+    SmpResult simulateMultiCore(const SmpOptions &options)
+    {
+        SmpResult result = SmpSimulator::run(readyJobs(), options);
+        logAction("Simulated " + to_string(result.jobs.size()) + " processes on " + to_string(result.cpus.size()) + " CPUs: makespan " + to_string(result.makespan) +
+                  ", " + to_string(result.migrations) + " migrations, " + to_string(result.steals) + " steals.");
+        return result;
+    }
+
+    // Print per-CPU (up to maxCpus) and aggregate metrics of a multi-core run
+    void displayMultiCore(const SmpResult &result, size_t maxCpus)
+    {
+        cout << "Multi-core simulation of " << result.jobs.size() << " processes on " << result.cpus.size() << " CPUs" << endl;
+        cout << "CPU\t\tUtilization\tDispatches\tSwitches\tMigrated In\tMigrated Out" << endl;
+        for (size_t c = 0; c < result.cpus.size() && c < maxCpus; c++)
+        {
+            const CpuStats &cpu = result.cpus[c];
+            cout << c << "\t\t" << result.utilization(c) * 100 << "%\t\t" << cpu.dispatches << "\t\t" << cpu.contextSwitches << "\t\t" << cpu.migrationsIn << "\t\t" << cpu.migrationsOut << "\n";
+        }
+        if (result.cpus.size() > maxCpus)
+            cout << "... " << result.cpus.size() - maxCpus << " more CPUs\n";
+        cout << "Average turnaround time: " << result.avgTurnaround << "\n";
+        cout << "Average waiting time: " << result.avgWaiting << "\n";
+        cout << "Average response time: " << result.avgResponse << "\n";
+        cout << "Makespan: " << result.makespan << ", migrations: " << result.migrations << ", steals: " << result.steals << "\n";
+        cout << "Load imbalance: " << result.avgImbalance << " average, " << result.maxImbalance << " max over " << result.balancePasses << " balancing passes\n";
+        cout << "Elapsed: " << result.elapsedSeconds << " s" << endl;
+    }
+
+    // Simulate Round-Robin over the ready queue once per quantum (0 = adaptive)
+    vector<SimulationResult> quantumTradeoff(const vector<int> &quanta)
+    {
+        vector<SimJob> jobs = readyJobs();
+        vector<SimulationResult> results;
+        for (size_t i = 0; i < quanta.size(); i++)
+        {
+            SimulationOptions options(POLICY_RR);
+            options.setQuantum(quanta[i]);
+            results.push_back(SchedulerSimulator::run(jobs, options));
+        }
+        logAction("Compared " + to_string(quanta.size()) + " Round-Robin quanta over " + to_string(jobs.size()) + " processes.");
+        return results;
+    }
+
+    // Print context switches against throughput and latency for each quantum
+    void displayQuantumTradeoff(const vector<int> &quanta, const vector<SimulationResult> &results)
+    {
+        cout << "Quantum\t\tSwitches\tAvg Slice\tThroughput\tAvg Response\tAvg Turnaround" << endl;
+        for (size_t i = 0; i < results.size(); i++)
+            cout << quantumName(quanta[i]) << "\t\t" << results[i].contextSwitches << "\t\t" << results[i].averageSlice() << "\t\t" << results[i].throughput()
+                 << "\t" << results[i].avgResponse << "\t\t" << results[i].avgTurnaround << "\n";
+        cout << flush;
+    }
+
+    // Print per-process (up to maxRows) and aggregate metrics of a simulation run
+    void displaySimulation(const SimulationResult &result, size_t maxRows)
+    {
+        cout << policyName(result.policy) << " simulation of " << result.jobs.size() << " processes" << endl;
+        if (!result.jobs.empty() && maxRows > 0)
+        {
+            cout << "Process ID\tArrival Time\tBurst Time\tCompletion\tTurnaround\tWaiting\t\tResponse" << endl;
+            for (size_t i = 0; i < result.jobs.size() && i < maxRows; i++)
+            {
+                const SimJob &job = result.jobs[i];
+                cout << job.pid << "\t\t" << job.AT << "\t\t" << job.burst << "\t\t" << job.completion << "\t\t" << job.turnaround() << "\t\t" << job.waiting() << "\t\t" << job.response() << "\n";
+            }
+            if (result.jobs.size() > maxRows)
+                cout << "... " << result.jobs.size() - maxRows << " more processes\n";
+        }
+        cout << "Average turnaround time: " << result.avgTurnaround << "\n";
+        cout << "Average waiting time: " << result.avgWaiting << " (max " << result.maxWaiting << ")\n";
+        cout << "Average response time: " << result.avgResponse << " (p95 " << result.p95Response << ", p99 " << result.p99Response << ")\n";
+        cout << "Turnaround p95: " << result.p95Turnaround << ", p99: " << result.p99Turnaround << "\n";
+        cout << "Makespan: " << result.makespan << ", CPU utilization: " << result.utilization() * 100 << "%, throughput: " << result.throughput() << " processes/tick\n";
+        cout << "Context switches: " << result.contextSwitches << ", preemptions: " << result.preemptions << "\n";
+        if (result.deadlineJobs > 0)
+            cout << "Deadline misses: " << result.deadlineMisses << " of " << result.deadlineJobs << " (" << result.missRate() * 100 << "%), lateness avg " << result.avgLateness
+                 << ", p95 " << result.p95Lateness << ", p99 " << result.p99Lateness << ", max " << result.maxLateness << "\n";
+        cout << "Fairness error: " << result.fairnessError << " ticks (worst lag of any priority against its ticket share)\n";
+        cout << "Events: " << result.events << " in " << result.elapsedSeconds << " s (" << (long long)result.eventsPerSecond() << " events/s)" << endl;
+    }
+
+    int readyCount() const { return readyQueue.size; }
+    int runningCount() const { return runningQueue.size; }
+    int blockedCount() const { return blockedQueue.size; }
+
+    // View used by displayAll() after menu actions
+    void setDisplayOptions(const DisplayOptions &options)
+    {
+        displayOptions = options;
+    }
+
+    const DisplayOptions &getDisplayOptions() const
+    {
+        return displayOptions;
+    }
+
+    // Render the queues as options asks into one buffer and write it with a
+    // single flush; every view becomes the baseline of the next diff
+    void display(ostream &out, const DisplayOptions &options)
+    {
+        string buffer;
+        if (options.mode == DISPLAY_DIFF)
+            appendChanges(buffer, options);
+        else
+        {
+            appendList(buffer, "Ready Queue", readyQueue, options);
+            appendList(buffer, "Running Queue", runningQueue, options);
+            appendList(buffer, "Blocked Queue", blockedQueue, options);
+        }
+        recordShownState();
+        out.write(buffer.data(), buffer.size());
+        out.flush();
+    }
+
+    // Display all queues
+    void displayAll()
+    {
+        display(cout, displayOptions);
+    }
+};
+
+bool parseSchedulingPolicy(const string &name, SchedulingPolicy &policy)
+{
+    for (int p = 0; p < POLICY_COUNT; p++)
+        if (name == policyKey((SchedulingPolicy)p))
+        {
+            policy = (SchedulingPolicy)p;
+            return true;
+        }
+    return false;
+}
+
+bool parseReplacementAlgorithm(const string &name, ReplacementAlgorithm &algorithm)
+{
+    static const char *names[REPLACEMENT_COUNT] = {"lru", "fifo", "optimal", "clock", "lfu", "arc"};
+    for (int a = 0; a < REPLACEMENT_COUNT; a++)
+        if (name == names[a])
+        {
+            algorithm = (ReplacementAlgorithm)a;
+            return true;
+        }
+    return false;
+}
+
+bool parseLogLevel(const string &name, LogLevel &level)
+{
+    static const char *names[] = {"debug", "info", "warn", "error", "off"};
+    for (int l = LOG_DEBUG; l <= LOG_OFF; l++)
+        if (name == names[l])
+        {
+            level = (LogLevel)l;
+            return true;
+        }
+    return false;
+}
+
+bool parseArrivalPattern(const string &name, ArrivalPattern &pattern)
+{
+    for (int a = 0; a < ARRIVAL_COUNT; a++)
+        if (name == arrivalName((ArrivalPattern)a))
+        {
+            pattern = (ArrivalPattern)a;
+            return true;
+        }
+    return false;
+}
+
+bool parseBurstDistribution(const string &name, BurstDistribution &distribution)
+{
+    for (int b = 0; b < BURST_COUNT; b++)
+        if (name == burstName((BurstDistribution)b))
+        {
+            distribution = (BurstDistribution)b;
+            return true;
+        }
+    return false;
+}
+
+// Look up a display view by its command-line name; returns false if unknown
+bool parseDisplayMode(const string &name, DisplayMode &mode)
+{
+    for (int m = 0; m < DISPLAY_MODE_COUNT; m++)
+        if (name == displayModeName((DisplayMode)m))
+        {
+            mode = (DisplayMode)m;
+            return true;
+        }
+    return false;
+}
+
+// Split "key=value" into its parts; returns false for a bare word
+bool splitOption(const string &word, string &key, string &value)
+{
+    size_t eq = word.find('=');
+    if (eq == string::npos)
+        return false;
+    key = word.substr(0, eq);
+    value = word.substr(eq + 1);
+    return true;
+}
+
+// Parse a whole word as an int (a page reference, a deadline); false for
+// junk or a value outside int
+bool parseIntWord(const string &word, int &number)
+{
+    if (!isdigit((unsigned char)word[0]) && word[0] != '-')
+        return false;
+    char *end;
+    long long value = strtoll(word.c_str(), &end, 10); // Saturates, so huge values fail the range check
+    if (*end || value < INT_MIN || value > INT_MAX)
+        return false;
+    number = (int)value;
+    return true;
+}
+
+// Read the rest of a command as page references, or as "@path" naming a trace
+// file. The two forms cannot be mixed.
+bool readReferences(istream &words, vector<int> &pageReferences, string &tracePath)
+{
+    string word;
+    int page;
+    while (words >> word)
+    {
+        if (word[0] == '@' && pageReferences.empty() && tracePath.empty())
+            tracePath = word.substr(1);
+        else if (tracePath.empty() && parseIntWord(word, page))
+            pageReferences.push_back(page);
+        else
+            return false;
+    }
+    return true;
+}
+
+void writeReplacementLine(ostream &out, ReplacementAlgorithm algorithm, int numFrames, const ReplacementResult &result)
+{
+    out << "replace policy=" << replacementName(algorithm) << " frames=" << numFrames << " references=" << result.references()
+        << " hits=" << result.hits << " faults=" << result.faults << " fault_rate=" << result.faultRate() << '\n';
+}
+
+void writeSimulationLines(ostream &out, const SimulationResult &result, bool detail)
+{
+    out << "simulate policy=" << policyName(result.policy) << " processes=" << result.jobs.size()
+        << " avg_turnaround=" << result.avgTurnaround << " avg_waiting=" << result.avgWaiting << " max_waiting=" << result.maxWaiting
+        << " avg_response=" << result.avgResponse << " p95_response=" << result.p95Response << " p99_response=" << result.p99Response
+        << " p95_turnaround=" << result.p95Turnaround << " p99_turnaround=" << result.p99Turnaround << " makespan=" << result.makespan << " utilization=" << result.utilization()
+        << " throughput=" << result.throughput() << " context_switches=" << result.contextSwitches << " preemptions=" << result.preemptions << " events=" << result.events
+        << " fairness_error=" << result.fairnessError << " deadlines=" << result.deadlineJobs << " deadline_misses=" << result.deadlineMisses << " miss_rate=" << result.missRate()
+        << " avg_lateness=" << result.avgLateness << " p95_lateness=" << result.p95Lateness << " p99_lateness=" << result.p99Lateness << " max_lateness=" << result.maxLateness << '\n';
+    if (!detail)
+        return;
+    for (const TenantShare &share : result.tenants)
+        out << "tenant priority=" << share.priority << " tickets=" << share.tickets << " processes=" << share.processes << " received=" << share.received
+            << " entitled=" << share.entitled << " max_lag=" << share.maxLag << '\n';
+    for (size_t i = 0; i < result.jobs.size(); i++)
+    {
+        const SimJob &job = result.jobs[i];
+        out << "job pid=" << job.pid << " at=" << job.AT << " burst=" << job.burst << " completion=" << job.completion
+            << " turnaround=" << job.turnaround() << " waiting=" << job.waiting() << " response=" << job.response();
+        if (job.deadline >= 0)
+            out << " deadline=" << job.deadline << " lateness=" << job.completion - job.deadline;
+        out << '\n';
+    }
+}
+
+// Time each selection kernel over the columns and check that every
+// instruction set agrees with the scalar answer
+void writeScanLines(ostream &out, const ProcessColumns &columns, int picks, int quantum)
+{
+    static const char *pickNames[] = {"fcfs", "sjf", "priority"};
+    size_t expected[3] = {0, 0, 0}, expectedDispatched = 0;
+    SimdLevel best = detectSimdLevel();
+    for (int level = SIMD_SCALAR; level <= best; level++)
+    {
+        SimdLevel simd = (SimdLevel)level;
+        for (int p = 0; p < 3; p++)
+        {
+            size_t slot = columns.size();
+            chrono::steady_clock::time_point started = chrono::steady_clock::now();
+            for (int i = 0; i < picks; i++)
+                slot = p == 0 ? columns.pickFirstArrival(simd) : p == 1 ? columns.pickShortest(simd) : columns.pickHighestPriority(simd);
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+            if (level == SIMD_SCALAR)
+                expected[p] = slot;
+            // Key, arrival and pid columns plus state; FCFS keys on arrival itself
+            double bytes = (double)columns.size() * ((p == 0 ? 2 : 3) * sizeof(int32_t) + sizeof(uint8_t)) * picks;
+            out << "scan kernel=" << simdLevelName(simd) << " op=" << pickNames[p] << " processes=" << columns.size()
+                << " pid=" << (slot < columns.size() ? columns.pid[slot] : -1) << " ns_per_op=" << seconds * 1e9 / max(1, picks)
+                << " gb_per_s=" << (seconds > 0 ? bytes / seconds / 1e9 : 0.0) << " match=" << (slot == expected[p] ? "yes" : "no") << '\n';
+        }
+        ProcessColumns pass = columns;
+        chrono::steady_clock::time_point started = chrono::steady_clock::now();
+        size_t dispatched = pass.roundRobinPass(quantum, simd);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        if (level == SIMD_SCALAR)
+            expectedDispatched = dispatched;
+        double bytes = (double)columns.size() * (sizeof(int32_t) + sizeof(uint8_t)) * 2;
+        out << "scan kernel=" << simdLevelName(simd) << " op=rr_update processes=" << columns.size() << " dispatched=" << dispatched
+            << " ns_per_op=" << seconds * 1e9 << " gb_per_s=" << (seconds > 0 ? bytes / seconds / 1e9 : 0.0)
+            << " match=" << (dispatched == expectedDispatched ? "yes" : "no") << '\n';
+    }
+}
+
+// Run a workload file without prompts. Each non-empty line holds one command;
+// '#' starts a comment. Results are written to out as "command key=value ..."
+// lines, and queue tables are printed only by the display command.
+// Returns the number of lines that failed.
+int runBatch(ProcessManager &pm, istream &in, ostream &out)
+{
+    string line;
+    int lineNumber = 0;
+    int errors = 0;
+    while (getline(in, line))
+    {
+        lineNumber++;
+        size_t hash = line.find('#');
+        if (hash != string::npos)
+            line.erase(hash);
+        istringstream words(line);
+        string command;
+        if (!(words >> command))
+            continue;
+
+        string error;
+        if (command == "seed")
+        {
+            unsigned long long seed;
+            if (words >> seed)
+                pm.seedWorkload(seed);
+            else
+                error = "usage: seed N";
+        }
+        else if (command == "loglevel")
+        {
+            string name;
+            LogLevel level;
+            if (words >> name && parseLogLevel(name, level))
+                pm.setLogLevel(level);
+            else
+                error = "usage: loglevel debug|info|warn|error|off";
+        }
+        else if (command == "process")
+        {
+            int AT, BT, priority, deadline = -1;
+            string word;
+            if (!(words >> AT >> BT >> priority) || (words >> word && (!parseIntWord(word, deadline) || deadline < 0)))
+                error = "usage: process AT BT PRIORITY [DEADLINE]";
+            else
+                out << "process pid=" << pm.createProcess(AT, BT, priority, deadline) << '\n';
+        }
+        else if (command == "generate")
+        {
+            int numProcesses;
+            WorkloadSpec spec;
+            string word, key, value;
+            const string usage = "usage: generate N [arrivals=uniform|poisson] [span=T] [rate=R] [bursts=uniform|exponential|pareto|lognormal|bimodal] "
+                                 "[mean=M] [shape=S] [max=B] [interactive=P] [short=M] [priorities=K] [slack=F] [seed=S]";
+            if (!(words >> numProcesses) || numProcesses < 0)
+                error = usage;
+            while (error.empty() && words >> word)
+            {
+                if (!splitOption(word, key, value))
+                    error = usage;
+                else if (key == "arrivals" && parseArrivalPattern(value, spec.arrivals))
+                    continue;
+                else if (key == "bursts" && parseBurstDistribution(value, spec.bursts))
+                    continue;
+                else if (key == "span" && atoi(value.c_str()) > 0)
+                    spec.arrivalSpan = atoi(value.c_str());
+                else if (key == "rate" && atof(value.c_str()) > 0)
+                    spec.arrivalRate = atof(value.c_str());
+                else if (key == "mean" && atof(value.c_str()) >= 1)
+                    spec.meanBurst = atof(value.c_str());
+                else if (key == "shape" && atof(value.c_str()) > 0)
+                    spec.shape = atof(value.c_str());
+                else if (key == "max" && atoi(value.c_str()) > 0)
+                    spec.maxBurst = atoi(value.c_str());
+                else if (key == "interactive" && atof(value.c_str()) >= 0 && atof(value.c_str()) <= 1)
+                    spec.interactiveShare = atof(value.c_str());
+                else if (key == "short" && atof(value.c_str()) >= 1)
+                    spec.interactiveBurst = atof(value.c_str());
+                else if (key == "priorities" && atoi(value.c_str()) > 0)
+                    spec.priorities = atoi(value.c_str());
+                else if (key == "slack" && atof(value.c_str()) >= 0)
+                    spec.slack = atof(value.c_str());
+                else if (key == "seed")
+                    pm.seedWorkload(strtoull(value.c_str(), nullptr, 10));
+                else
+                    error = usage;
+            }
+            if (error.empty())
+            {
+                auto start = chrono::steady_clock::now();
+                pm.generateWorkload(spec, numProcesses);
+                double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                out << "generate count=" << numProcesses << " ready=" << pm.readyCount() << " arrivals=" << arrivalName(spec.arrivals)
+                    << " bursts=" << burstName(spec.bursts) << " seconds=" << seconds << '\n';
+            }
+        }
+        else if (command == "refs")
+        {
+            long long count;
+            LocalitySpec spec;
+            string path, word, key, value;
+            const string usage = "usage: refs COUNT out=PATH [pages=P] [set=W] [phase=L] [locality=p] [seed=S]";
+            if (!(words >> count) || count < 0)
+                error = usage;
+            while (error.empty() && words >> word)
+            {
+                if (!splitOption(word, key, value))
+                    error = usage;
+                else if (key == "out" && !value.empty())
+                    path = value;
+                else if (key == "pages" && atoi(value.c_str()) > 0)
+                    spec.pages = atoi(value.c_str());
+                else if (key == "set" && atoi(value.c_str()) > 0)
+                    spec.workingSet = atoi(value.c_str());
+                else if (key == "phase" && atoi(value.c_str()) > 0)
+                    spec.phaseLength = atoi(value.c_str());
+                else if (key == "locality" && atof(value.c_str()) >= 0 && atof(value.c_str()) <= 1)
+                    spec.locality = atof(value.c_str());
+                else if (key == "seed")
+                    pm.seedWorkload(strtoull(value.c_str(), nullptr, 10));
+                else
+                    error = usage;
+            }
+            if (error.empty() && path.empty())
+                error = usage;
+            if (error.empty())
+            {
+                vector<int> references = pm.generatePageReferences(spec, (size_t)count);
+                if (!writePageTrace(path, references))
+                    error = "unable to write page trace " + path;
+                else
+                    out << "refs count=" << references.size() << " pages=" << spec.pages << " set=" << spec.workingSet << " path=" << path << '\n';
+            }
+        }
+        else if (command == "destroy" || command == "suspend" || command == "block" || command == "dispatch")
+        {
+            int pid;
+            if (!(words >> pid))
+                error = "usage: " + command + " PID";
+            else
+            {
+                bool ok;
+                if (command == "destroy")
+                    ok = pm.destroyProcess(pid);
+                else if (command == "suspend")
+                    ok = pm.suspendProcess(pid);
+                else if (command == "block")
+                    ok = pm.blockProcess(pid);
+                else
+                    ok = pm.dispatchProcess(pid);
+                out << command << " pid=" << pid << " status=" << (ok ? "ok" : "not_found") << '\n';
+            }
+        }
+        else if (command == "resume" || command == "wakeup")
+        {
+            bool ok = command == "resume" ? pm.resumeProcess() : pm.wakeupProcess();
+            out << command << " status=" << (ok ? "ok" : "empty") << '\n';
+        }
+        else if (command == "priority")
+        {
+            int pid, newPriority;
+            if (words >> pid >> newPriority)
+                out << "priority pid=" << pid << " status=" << (pm.changeProcessPriority(pid, newPriority) ? "ok" : "not_found") << '\n';
+            else
+                error = "usage: priority PID VALUE";
+        }
+        else if (command == "send")
+        {
+            int senderPid, receiverPid;
+            string message;
+            if (words >> senderPid >> receiverPid)
+            {
+                getline(words >> ws, message);
+                out << "send from=" << senderPid << " to=" << receiverPid << " status=" << sendStatusName(pm.processCommunication(senderPid, receiverPid, message)) << '\n';
+            }
+            else
+                error = "usage: send FROM TO MESSAGE";
+        }
+        else if (command == "receive")
+        {
+            int pid;
+            Message message;
+            if (!(words >> pid))
+                error = "usage: receive PID";
+            else
+            {
+                ReceiveStatus status = pm.receiveMessage(pid, message);
+                out << "receive pid=" << pid << " status=" << receiveStatusName(status);
+                if (status == RECEIVE_OK)
+                    out << " from=" << message.sender << " message=\"" << message.payload << '"';
+                out << '\n';
+            }
+        }
+        else if (command == "mailbox")
+        {
+            string word, key, value;
+            if (!(words >> word))
+                error = "usage: mailbox PID | mailbox capacity=N";
+            else if (splitOption(word, key, value))
+            {
+                if (key == "capacity" && pm.setMailboxCapacity(atoi(value.c_str())))
+                {
+                    out << "mailbox capacity=" << atoi(value.c_str()) << '\n';
+                }
+                else
+                    error = "usage: mailbox PID | mailbox capacity=N";
+            }
+            else
+                out << "mailbox pid=" << atoi(word.c_str()) << " pending=" << pm.pendingMessages(atoi(word.c_str())) << '\n';
+        }
+        else if (command == "ipc")
+        {
+            long long count = 1000000;
+            int processes = 2, size = 64;
+            string word, key, value;
+            while (error.empty() && words >> word)
+            {
+                if (splitOption(word, key, value) && key == "count" && atoll(value.c_str()) > 0)
+                    count = atoll(value.c_str());
+                else if (splitOption(word, key, value) && key == "processes" && atoi(value.c_str()) >= 2)
+                    processes = atoi(value.c_str());
+                else if (splitOption(word, key, value) && key == "size" && atoi(value.c_str()) >= 0)
+                    size = atoi(value.c_str());
+                else
+                    error = "usage: ipc [count=N] [processes=P] [size=BYTES]";
+            }
+            if (error.empty())
+            {
+                double seconds;
+                long long delivered = pm.runMessageWorkload(processes, count, size, seconds);
+                out << "ipc messages=" << delivered << " processes=" << processes << " size=" << size << " seconds=" << seconds
+                    << " messages_per_sec=" << (seconds > 0 ? (long long)(delivered / seconds) : 0) << '\n';
+            }
+        }
+        else if (command == "schedule")
+        {
+            string name, mode;
+            SchedulingPolicy policy;
+            if (!(words >> name) || !parseSchedulingPolicy(name, policy))
+                error = "usage: schedule fcfs|priority|sjf|rr|mlq|mlfq|lottery|stride|srtf|edf [all]";
+            else
+            {
+                bool drainAll = words >> mode && mode == "all";
+                double fairness = -1;
+                if (policy == POLICY_FCFS)
+                    pm.fcfs(drainAll);
+                else if (policy == POLICY_PRIORITY)
+                    pm.priorityScheduling(drainAll);
+                else if (policy == POLICY_SJF)
+                    pm.sjf(drainAll);
+                else if (policy == POLICY_RR)
+                    pm.roundRobin();
+                else if (policy == POLICY_MLQ)
+                    pm.multilevelQueueScheduling();
+                else if (policy == POLICY_LOTTERY)
+                    fairness = pm.lotteryScheduling(drainAll);
+                else if (policy == POLICY_STRIDE)
+                    fairness = pm.strideScheduling(drainAll);
+                else if (policy == POLICY_SRTF)
+                    pm.srtf(drainAll);
+                else if (policy == POLICY_EDF)
+                    pm.edf(drainAll);
+                else
+                    pm.multilevelFeedbackScheduling(drainAll);
+                out << "schedule policy=" << policyName(policy) << " ready=" << pm.readyCount() << " running=" << pm.runningCount() << " blocked=" << pm.blockedCount();
+                if (fairness >= 0)
+                    out << " fairness_error=" << fairness;
+                if (policy == POLICY_SRTF || policy == POLICY_EDF)
+                    out << " holder=" << pm.preemptiveHolder() << " preemptions=" << pm.preemptionCount();
+                out << '\n';
+            }
+        }
+        else if (command == "simulate")
+        {
+            string name, word, key, value;
+            SimulationOptions options;
+            bool detail = false;
+            if (!(words >> name) || !parseSchedulingPolicy(name, options.policy))
+                error = "usage: simulate fcfs|priority|sjf|rr|mlq|mlfq|lottery|stride|srtf|edf [quantum=Q|adaptive] [threshold=T] [levels=N] [boost=B] [seed=S] [detail]";
+            else if (options.policy == POLICY_MLFQ)
+                options = pm.simulationOptions(POLICY_MLFQ); // Start from the live mlfq settings
+            while (error.empty() && words >> word)
+            {
+                if (word == "detail")
+                    detail = true;
+                else if (splitOption(word, key, value) && key == "quantum" && (value == "adaptive" || atoi(value.c_str()) > 0))
+                    options.setQuantum(value == "adaptive" ? 0 : atoi(value.c_str()));
+                else if (splitOption(word, key, value) && key == "threshold")
+                    options.mlqThreshold = atoi(value.c_str());
+                else if (splitOption(word, key, value) && key == "levels" && atoi(value.c_str()) > 0)
+                    options.mlfqLevels = atoi(value.c_str());
+                else if (splitOption(word, key, value) && key == "boost" && atoi(value.c_str()) >= 0)
+                    options.boostInterval = atoi(value.c_str());
+                else if (splitOption(word, key, value) && key == "seed")
+                    options.seed = strtoull(value.c_str(), nullptr, 10);
+                else
+                    error = "unknown simulate option " + word;
+            }
+            if (error.empty())
+                writeSimulationLines(out, pm.simulateScheduling(options), detail);
+        }
+        else if (command == "quantum")
+        {
+            string value;
+            if (words >> value && (value == "adaptive" || atoi(value.c_str()) > 0))
+            {
+                pm.setTimeQuantum(value == "adaptive" ? 0 : atoi(value.c_str()));
+                out << "quantum value=" << quantumName(pm.getTimeQuantum()) << '\n';
+            }
+            else
+                error = "usage: quantum Q|adaptive";
+        }
+        else if (command == "mlfq")
+        {
+            int levels = pm.feedbackLevelCount(), baseQuantum = pm.feedbackBaseQuantum(), boost = pm.feedbackBoostInterval();
+            string word, key, value;
+            while (error.empty() && words >> word)
+            {
+                if (splitOption(word, key, value) && key == "levels")
+                    levels = atoi(value.c_str());
+                else if (splitOption(word, key, value) && key == "quantum")
+                    baseQuantum = atoi(value.c_str());
+                else if (splitOption(word, key, value) && key == "boost")
+                    boost = atoi(value.c_str());
+                else
+                    error = "usage: mlfq [levels=N] [quantum=Q] [boost=B]";
+            }
+            if (error.empty())
+            {
+                if (pm.configureFeedbackQueue(levels, baseQuantum, boost))
+                    out << "mlfq levels=" << levels << " quantum=" << baseQuantum << " boost=" << boost << '\n';
+                else
+                    error = "invalid feedback queue settings";
+            }
+        }
+        else if (command == "clear")
+        {
+            pm.destroyAllProcesses();
+            out << "clear ready=" << pm.readyCount() << " running=" << pm.runningCount() << " blocked=" << pm.blockedCount() << '\n';
+        }
+        else if (command == "affinity")
+        {
+            int pid, cpu;
+            if (!(words >> pid >> cpu) || cpu < -1)
+                error = "usage: affinity PID CPU (-1 = any)";
+            else
+                out << "affinity pid=" << pid << " cpu=" << cpu << " status=" << (pm.setProcessAffinity(pid, cpu) ? "ok" : "not_found") << '\n';
+        }
+        else if (command == "smp")
+        {
+            SmpOptions options;
+            bool detail = false;
+            string word, key, value;
+            while (error.empty() && words >> word)
+            {
+                int number = splitOption(word, key, value) ? atoi(value.c_str()) : 0;
+                if (word == "detail")
+                    detail = true;
+                else if (key == "cpus" && number > 0)
+                    options.cpus = number;
+                else if (key == "quantum" && number > 0)
+                    options.timeQuantum = number;
+                else if (key == "interval" && number > 0)
+                    options.balanceInterval = number;
+                else if (key == "push")
+                    options.pushMigration = number != 0;
+                else if (key == "steal")
+                    options.workStealing = number != 0;
+                else if (key == "threads" && number > 0)
+                    options.threads = number;
+                else
+                    error = "usage: smp [cpus=K] [quantum=Q] [interval=I] [push=0|1] [steal=0|1] [threads=T] [detail]";
+                key.clear();
+            }
+            if (error.empty())
+            {
+                SmpResult result = pm.simulateMultiCore(options);
+                double low = 1.0, high = 0.0;
+                for (size_t c = 0; c < result.cpus.size(); c++)
+                {
+                    low = min(low, result.utilization(c));
+                    high = max(high, result.utilization(c));
+                }
+                out << "smp cpus=" << result.cpus.size() << " processes=" << result.jobs.size() << " avg_turnaround=" << result.avgTurnaround
+                    << " avg_waiting=" << result.avgWaiting << " avg_response=" << result.avgResponse << " makespan=" << result.makespan
+                    << " migrations=" << result.migrations << " steals=" << result.steals << " avg_imbalance=" << result.avgImbalance
+                    << " max_imbalance=" << result.maxImbalance << " min_utilization=" << low << " max_utilization=" << high << '\n';
+                for (size_t c = 0; detail && c < result.cpus.size(); c++)
+                {
+                    const CpuStats &cpu = result.cpus[c];
+                    out << "cpu id=" << c << " utilization=" << result.utilization(c) << " dispatches=" << cpu.dispatches << " context_switches=" << cpu.contextSwitches
+                        << " migrations_in=" << cpu.migrationsIn << " migrations_out=" << cpu.migrationsOut << '\n';
+                }
+            }
+        }
+        else if (command == "scan")
+        {
+            int count = 0, picks = 10, quantum = 10;
+            unsigned seed = 1;
+            string word, key, value;
+            while (error.empty() && words >> word)
+            {
+                if (!splitOption(word, key, value))
+                    error = "usage: scan [count=N] [picks=P] [quantum=Q] [seed=S]";
+                else if (key == "count")
+                    count = atoi(value.c_str());
+                else if (key == "picks" && atoi(value.c_str()) > 0)
+                    picks = atoi(value.c_str());
+                else if (key == "quantum" && atoi(value.c_str()) > 0)
+                    quantum = atoi(value.c_str());
+                else if (key == "seed")
+                    seed = (unsigned)strtoul(value.c_str(), nullptr, 10);
+                else
+                    error = "usage: scan [count=N] [picks=P] [quantum=Q] [seed=S]";
+            }
+            if (error.empty())
+            {
+                ProcessColumns columns;
+                if (count > 0)
+                {
+                    // Synthetic store: a tenth of the processes are not ready
+                    mt19937 rng(seed);
+                    columns.reserve(count);
+                    for (int i = 0; i < count; i++)
+                    {
+                        int BT = (int)(rng() % 100);
+                        columns.add(i + 1, (int)(rng() % 100000), BT, BT, (int)(rng() % 10), rng() % 10 == 0 ? STATE_BLOCKED : STATE_READY);
+                    }
+                }
+                else
+                    columns = pm.readyColumns();
+                writeScanLines(out, columns, picks, quantum);
+            }
+        }
+        else if (command == "tradeoff")
+        {
+            vector<int> quanta;
+            string value;
+            while (error.empty() && words >> value)
+            {
+                if (value == "adaptive" || atoi(value.c_str()) > 0)
+                    quanta.push_back(value == "adaptive" ? 0 : atoi(value.c_str()));
+                else
+                    error = "invalid quantum " + value;
+            }
+            if (quanta.empty() && error.empty())
+                error = "usage: tradeoff Q1 Q2 ... [adaptive]";
+            if (error.empty())
+            {
+                vector<SimulationResult> results = pm.quantumTradeoff(quanta);
+                for (size_t i = 0; i < results.size(); i++)
+                    out << "tradeoff quantum=" << quantumName(quanta[i]) << " context_switches=" << results[i].contextSwitches << " dispatches=" << results[i].dispatches
+                        << " avg_slice=" << results[i].averageSlice() << " throughput=" << results[i].throughput() << " avg_response=" << results[i].avgResponse
+                        << " avg_turnaround=" << results[i].avgTurnaround << " avg_waiting=" << results[i].avgWaiting << '\n';
+            }
+        }
+        else if (command == "pagesize")
+        {
+            int pid, pageSize;
+            if (words >> pid >> pageSize)
+                out << "pagesize pid=" << pid << " status=" << (pm.setPageSize(pid, pageSize) ? "ok" : "not_found") << '\n';
+            else
+                error = "usage: pagesize PID SIZE";
+        }
+        else if (command == "pages")
+        {
+            int pid, memoryAllocated, processSize;
+            if (words >> pid >> memoryAllocated >> processSize)
+                out << "pages pid=" << pid << " status=" << (pm.calculatePages(pid, memoryAllocated, processSize) ? "ok" : "failed") << '\n';
+            else
+                error = "usage: pages PID MEMORY SIZE";
+        }
+        else if (command == "paging")
+        {
+            int pid;
+            if (words >> pid)
+                out << "paging pid=" << pid << " status=" << (pm.performPaging(pid) ? "ok" : "not_found") << '\n';
+            else
+                error = "usage: paging PID";
+        }
+        else if (command == "vm")
+        {
+            const VirtualMemory &current = pm.virtualMemory();
+            int frames = current.frameCount(), pageSize = current.pageSize(), tlbSets = (int)current.tlbSets(), tlbWays = current.tlbWays(), bits = current.virtualAddressBits();
+            string word, key, value;
+            while (error.empty() && words >> word)
+            {
+                if (!splitOption(word, key, value))
+                    error = "usage: vm [frames=F] [pagesize=P] [tlb=SETSxWAYS] [bits=B]";
+                else if (key == "frames")
+                    frames = atoi(value.c_str());
+                else if (key == "pagesize")
+                    pageSize = atoi(value.c_str());
+                else if (key == "tlb" && sscanf(value.c_str(), "%dx%d", &tlbSets, &tlbWays) == 2)
+                    ;
+                else if (key == "bits")
+                    bits = atoi(value.c_str());
+                else
+                    error = "usage: vm [frames=F] [pagesize=P] [tlb=SETSxWAYS] [bits=B]";
+            }
+            if (error.empty() && !pm.configureMemory(frames, pageSize, tlbSets, tlbWays, bits))
+                error = "invalid memory settings";
+            if (error.empty())
+                out << "vm frames=" << current.frameCount() << " page_size=" << current.pageSize() << " tlb_sets=" << current.tlbSets()
+                    << " tlb_ways=" << current.tlbWays() << " bits=" << current.virtualAddressBits() << '\n';
+        }
+        else if (command == "access")
+        {
+            int pid;
+            unsigned long long vaddr;
+            if (!(words >> pid))
+                error = "usage: access PID ADDRESS...";
+            while (error.empty() && words >> vaddr)
+            {
+                long long paddr = pm.translateAddress(pid, vaddr);
+                out << "access pid=" << pid << " vaddr=" << vaddr << " paddr=" << paddr << '\n';
+            }
+        }
+        else if (command == "vmrun")
+        {
+            int pid = 0;
+            long long count = 0;
+            unsigned long long pages = ULLONG_MAX, seed = 1;
+            string tracePath, word, key, value;
+            if (!(words >> pid))
+                error = "usage: vmrun PID count=N [pages=K] [seed=S] | vmrun PID @trace";
+            while (error.empty() && words >> word)
+            {
+                if (word[0] == '@')
+                    tracePath = word.substr(1);
+                else if (splitOption(word, key, value) && key == "count")
+                    count = atoll(value.c_str());
+                else if (splitOption(word, key, value) && key == "pages")
+                    pages = strtoull(value.c_str(), nullptr, 10);
+                else if (splitOption(word, key, value) && key == "seed")
+                    seed = strtoull(value.c_str(), nullptr, 10);
+                else
+                    error = "usage: vmrun PID count=N [pages=K] [seed=S] | vmrun PID @trace";
+            }
+            if (error.empty())
+            {
+                double seconds;
+                VmStats run = tracePath.empty() ? pm.runMemoryWorkload(pid, count, pages, seed, seconds) : pm.runMemoryTrace(pid, tracePath, seconds);
+                out << "vmrun pid=" << pid << " accesses=" << run.accesses << " tlb_hits=" << run.tlbHits << " tlb_misses=" << run.tlbMisses
+                    << " page_faults=" << run.pageFaults << " evictions=" << run.evictions << " invalid=" << run.invalid
+                    << " tlb_hit_rate=" << run.tlbHitRate() << " fault_rate=" << run.faultRate()
+                    << " ns_per_access=" << (run.accesses ? seconds * 1e9 / run.accesses : 0.0) << '\n';
+            }
+        }
+        else if (command == "vmstats")
+        {
+            const VmStats &stats = pm.memoryCounters();
+            out << "vmstats accesses=" << stats.accesses << " tlb_hits=" << stats.tlbHits << " tlb_misses=" << stats.tlbMisses
+                << " page_faults=" << stats.pageFaults << " evictions=" << stats.evictions << " invalid=" << stats.invalid
+                << " free_frames=" << pm.virtualMemory().freeFrames() << '\n';
+        }
+        else if (command == "replace" || command == "compare")
+        {
+            string name;
+            int numFrames;
+            ReplacementAlgorithm algorithm = REPLACEMENT_LRU;
+            if (command == "replace" && (!(words >> name) || !parseReplacementAlgorithm(name, algorithm)))
+                error = "usage: replace lru|fifo|optimal|clock|lfu|arc FRAMES REFS...|@TRACE";
+            else if (!(words >> numFrames) || numFrames <= 0)
+                error = "usage: " + command + (command == "replace" ? " POLICY" : "") + " FRAMES REFS...|@TRACE";
+            else
+            {
+                vector<int> pageReferences;
+                string tracePath;
+                if (!readReferences(words, pageReferences, tracePath))
+                    error = "invalid page reference";
+                else if (command == "replace")
+                {
+                    ReplacementResult result;
+                    if (tracePath.empty())
+                        result = runReplacement(algorithm, numFrames, pageReferences, false, pm.traceWriter());
+                    else if (!runReplacementTrace(algorithm, numFrames, tracePath, result, pm.traceWriter()))
+                        error = "unable to read page trace " + tracePath;
+                    if (error.empty())
+                        writeReplacementLine(out, algorithm, numFrames, result);
+                }
+                else
+                {
+                    vector<ReplacementResult> results = tracePath.empty() ? pm.compareReplacementPolicies(numFrames, pageReferences)
+                                                                         : pm.compareReplacementPoliciesFromTrace(numFrames, tracePath);
+                    if (results.empty())
+                        error = "unable to read page trace " + tracePath;
+                    for (size_t a = 0; a < results.size(); a++)
+                        writeReplacementLine(out, (ReplacementAlgorithm)a, numFrames, results[a]);
+                }
+            }
+        }
+        else if (command == "mrc")
+        {
+            int maxFrames, page;
+            double samplingRate = 1.0;
+            string csvPath, tracePath, word, key, value;
+            vector<int> pageReferences;
+            if (!(words >> maxFrames) || maxFrames <= 0)
+                error = "usage: mrc MAXFRAMES [rate=R] [csv=PATH] REFS...|@TRACE";
+            while (error.empty() && words >> word)
+            {
+                if (splitOption(word, key, value) && key == "rate")
+                    samplingRate = atof(value.c_str());
+                else if (splitOption(word, key, value) && key == "csv")
+                    csvPath = value;
+                else if (word[0] == '@' && pageReferences.empty() && tracePath.empty())
+                    tracePath = word.substr(1);
+                else if (tracePath.empty() && parseIntWord(word, page))
+                    pageReferences.push_back(page);
+                else
+                    error = "usage: mrc MAXFRAMES [rate=R] [csv=PATH] REFS...|@TRACE";
+            }
+            if (error.empty())
+            {
+                vector<MissRatioPoint> points = tracePath.empty() ? pm.missRatioCurve(maxFrames, pageReferences, samplingRate, csvPath)
+                                                                  : pm.missRatioCurveFromTrace(maxFrames, tracePath, samplingRate, csvPath);
+                if (points.empty())
+                    error = "unable to read page trace " + tracePath;
+                for (size_t i = 0; i < points.size(); i++)
+                    out << "mrc frames=" << points[i].frames << " faults=" << points[i].faults << " fault_rate=" << points[i].faultRate << '\n';
+            }
+        }
+        else if (command == "sweep")
+        {
+            SweepGrid grid;
+            vector<int> pageReferences;
+            string tracePath, word, key, value;
+            while (error.empty() && words >> word)
+            {
+                if (word[0] == '@')
+                {
+                    tracePath = word.substr(1);
+                    continue;
+                }
+                if (!splitOption(word, key, value))
+                {
+                    error = "unknown sweep option " + word;
+                    break;
+                }
+                istringstream items(value);
+                string item;
+                while (error.empty() && getline(items, item, ','))
+                {
+                    SchedulingPolicy policy;
+                    ReplacementAlgorithm algorithm;
+                    int page;
+                    if (key == "policies" && parseSchedulingPolicy(item, policy))
+                        grid.policies.push_back(policy);
+                    else if (key == "quanta" && item == "adaptive")
+                        grid.quanta.push_back(0);
+                    else if (key == "quanta" && atoi(item.c_str()) > 0)
+                        grid.quanta.push_back(atoi(item.c_str()));
+                    else if (key == "algorithms" && parseReplacementAlgorithm(item, algorithm))
+                        grid.algorithms.push_back(algorithm);
+                    else if (key == "frames" && atoi(item.c_str()) > 0)
+                        grid.frameCounts.push_back(atoi(item.c_str()));
+                    else if (key == "refs" && parseIntWord(item, page))
+                        pageReferences.push_back(page);
+                    else if (key == "replicates" && atoi(item.c_str()) > 0)
+                        grid.replicates = atoi(item.c_str());
+                    else if (key == "processes" && atoi(item.c_str()) >= 0)
+                        grid.randomProcesses = atoi(item.c_str());
+                    else if (key == "seed")
+                        grid.seed = (unsigned)strtoul(item.c_str(), nullptr, 10);
+                    else if (key == "threads" && atoi(item.c_str()) > 0)
+                        grid.threads = atoi(item.c_str());
+                    else
+                        error = "invalid sweep option " + word;
+                }
+            }
+            if (error.empty())
+            {
+                vector<SweepRow> rows = pm.sweep(grid, pageReferences, tracePath);
+                for (size_t i = 0; i < rows.size(); i++)
+                {
+                    const SweepRow &row = rows[i];
+                    if (row.scheduling)
+                    {
+                        const SimulationResult &result = row.simulation;
+                        out << "sweep kind=schedule policy=" << policyName(result.policy) << " quantum=" << quantumName(row.quantum) << " replicate=" << row.replicate
+                            << " processes=" << result.jobs.size() << " avg_turnaround=" << result.avgTurnaround << " avg_waiting=" << result.avgWaiting
+                            << " avg_response=" << result.avgResponse << " makespan=" << result.makespan << " context_switches=" << result.contextSwitches
+                            << " preemptions=" << result.preemptions << " fairness_error=" << result.fairnessError << " deadline_misses=" << result.deadlineMisses
+                            << " p99_lateness=" << result.p99Lateness << '\n';
+                    }
+                    else if (row.failed)
+                        error = "unable to read page trace " + tracePath;
+                    else
+                    {
+                        const ReplacementResult &result = row.replacement;
+                        out << "sweep kind=replace policy=" << replacementName((ReplacementAlgorithm)row.policy) << " frames=" << row.quantum
+                            << " references=" << result.references() << " faults=" << result.faults << " fault_rate=" << result.faultRate() << '\n';
+                    }
+                }
+            }
+        }
+        else if (command == "stats")
+        {
+            string word, key, value, path;
+            int interval = 0;
+            if (!(words >> word))
+                pm.writeStats(out);
+            else if (word == "reset")
+            {
+                pm.resetStats();
+                out << "stats status=reset\n";
+            }
+            else if (word == "stop")
+            {
+                pm.stopStatsDump();
+                out << "stats status=stopped\n";
+            }
+            else
+            {
+                do
+                {
+                    if (splitOption(word, key, value) && key == "every" && atoi(value.c_str()) > 0)
+                        interval = atoi(value.c_str());
+                    else if (splitOption(word, key, value) && key == "out" && !value.empty())
+                        path = value;
+                    else
+                        error = "usage: stats [reset|stop|every=MS out=PATH]";
+                } while (error.empty() && words >> word);
+                if (error.empty() && (interval == 0 || path.empty()))
+                    error = "usage: stats [reset|stop|every=MS out=PATH]";
+                else if (error.empty() && !EAGLE_INSTRUMENT)
+                    error = "instrumentation is compiled out (EAGLE_INSTRUMENT=0)";
+                else if (error.empty() && !pm.startStatsDump(path, interval))
+                    error = "unable to start stats dump to " + path;
+                else if (error.empty())
+                    out << "stats dump=" << path << " every_ms=" << interval << '\n';
+            }
+        }
+        else if (command == "save" || command == "restore")
+        {
+            string path;
+            if (!(words >> path))
+                error = "usage: " + command + " PATH";
+            else
+            {
+                auto start = chrono::steady_clock::now();
+                uint64_t bytes = 0;
+                if (command == "save" && !pm.saveSnapshot(path, bytes))
+                    error = "unable to write snapshot " + path;
+                else if (command == "restore")
+                    pm.restoreSnapshot(path, error);
+                double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                if (error.empty())
+                {
+                    out << command << " path=" << path << " ready=" << pm.readyCount() << " running=" << pm.runningCount() << " blocked=" << pm.blockedCount();
+                    if (command == "save")
+                        out << " bytes=" << bytes;
+                    out << " seconds=" << seconds << '\n';
+                }
+            }
+        }
+        else if (command == "display")
+        {
+            // Plain "display" lists everything; rows= or page= alone selects page mode
+            DisplayOptions options(DISPLAY_ALL);
+            bool modeGiven = false, paged = false;
+            string word, key, value;
+            while (error.empty() && words >> word)
+            {
+                if (parseDisplayMode(word, options.mode))
+                    modeGiven = true;
+                else if (splitOption(word, key, value) && key == "rows" && atoi(value.c_str()) > 0)
+                    options.rows = atoi(value.c_str());
+                else if (splitOption(word, key, value) && key == "page" && isdigit((unsigned char)value[0]))
+                    options.page = atoi(value.c_str());
+                else
+                    error = "usage: display [all|page|summary|diff] [rows=N] [page=P]";
+                paged = paged || key == "rows" || key == "page";
+            }
+            if (!modeGiven && paged)
+                options.mode = DISPLAY_PAGE;
+            if (error.empty())
+            {
+                out << flush;
+                pm.display(out, options);
+            }
+        }
+        else
+            error = "unknown command " + command;
+
+        if (!error.empty())
+        {
+            out << "error line=" << lineNumber << " message=\"" << error << "\"\n";
+            errors++;
+        }
+    }
+    out << flush;
+    return errors;
+}
+
+// Hot paths timed by --bench. Every case counts its own operations:
+// churn = one create or destroy, the scheduling cases = one process dispatched
+// until the ready queue drains, transitions = one queue move, lru = one reference.
+const char *BENCH_CASES[] = {"churn", "fcfs", "priority", "sjf", "rr", "mlfq", "lottery", "stride", "srtf", "edf", "transitions", "lru"};
+const int BENCH_CASE_COUNT = sizeof(BENCH_CASES) / sizeof(BENCH_CASES[0]);
+
+struct BenchOptions
+{
+    vector<int> sizes;
+    vector<string> cases;
+    int warmup;      // Untimed runs before the trials
+    int trials;
+    uint64_t seed;
+
+    BenchOptions() : sizes{1000, 10000, 100000, 1000000, 10000000}, cases(BENCH_CASES, BENCH_CASES + BENCH_CASE_COUNT), warmup(1), trials(5), seed(1) {}
+};
+
+// Peak resident set size of this process in KiB since it started or, on
+// Linux, since the last resetPeakResident (0 where unavailable)
+long peakResidentKb()
+{
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return usage.ru_maxrss;
+#endif
+}
+
+// Reset the resident high-water mark so the next peakResidentKb covers only
+// what runs after this call. Returns false where it cannot be reset.
+bool resetPeakResident()
+{
+#ifdef __linux__
+    ofstream refs("/proc/self/clear_refs");
+    refs << "5";
+    refs.close();
+    return !refs.fail();
+#else
+    return false;
+#endif
+}
+
+// Run one trial of a benchmark case on size processes or references. Setup
+// runs on a fresh manager outside the timed region. Returns the operation count.
+long long runBenchTrial(const string &name, int size, uint64_t seed, double &seconds)
+{
+    unique_ptr<ProcessManager> pm(new ProcessManager());
+    pm->setConsoleOutput(false);
+    // Per-operation info records would measure the log file, not the path
+    pm->setLogLevel(LOG_WARN);
+    pm->seedWorkload(seed);
+
+    vector<SimJob> jobs;
+    vector<int> references;
+    if (name == "churn")
+        jobs = WorkloadGenerator(seed).generate(WorkloadSpec(), size);
+    else if (name == "lru")
+    {
+        LocalitySpec spec;
+        spec.pages = max(1024, size / 100);
+        spec.workingSet = 64;
+        WorkloadGenerator(seed).pageReferences(spec, size, references);
+    }
+    else
+        pm->generateWorkload(WorkloadSpec(), size);
+
+    long long ops = size;
+    auto start = chrono::steady_clock::now();
+    if (name == "churn")
+    {
+        pm->reserveProcesses(size);
+        for (const SimJob &job : jobs)
+            pm->createProcess(job.AT, job.burst, job.priority);
+        for (int pid = 1; pid <= size; pid++)
+            pm->destroyProcess(pid);
+        ops = 2LL * size;
+    }
+    else if (name == "fcfs")
+        pm->fcfs(true);
+    else if (name == "priority")
+        pm->priorityScheduling(true);
+    else if (name == "sjf")
+        pm->sjf(true);
+    else if (name == "rr")
+    {
+        while (pm->readyCount() > 0)
+            pm->roundRobin();
+    }
+    else if (name == "mlfq")
+        pm->multilevelFeedbackScheduling(true);
+    else if (name == "lottery")
+        pm->lotteryScheduling(true);
+    else if (name == "stride")
+        pm->strideScheduling(true);
+    else if (name == "srtf")
+        pm->srtf(true);
+    else if (name == "edf")
+        pm->edf(true);
+    else if (name == "transitions")
+    {
+        for (int pid = 1; pid <= size; pid++)
+        {
+            pm->dispatchProcess(pid);
+            pm->blockProcess(pid);
+        }
+        while (pm->wakeupProcess())
+            ;
+        ops = 3LL * size;
+    }
+    else if (name == "lru")
+        pm->performLRU(256, references);
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return ops;
+}
+
+// Time every case at every size and write the results as one JSON document.
+// Each result holds the median and best ns/op over the trials, the median
+// throughput and the peak RSS during its trials; the peak of the whole run
+// follows the results.
+void runBenchmarks(const BenchOptions &options, ostream &out)
+{
+    out << "{\n  \"warmup\": " << options.warmup << ",\n  \"trials\": " << options.trials << ",\n  \"seed\": " << options.seed
+        << ",\n  \"simd\": \"" << simdLevelName(detectSimdLevel()) << "\",\n  \"results\": [";
+    bool first = true;
+    long runPeakKb = 0;
+    for (const string &name : options.cases)
+        for (int size : options.sizes)
+        {
+            double seconds;
+            for (int w = 0; w < options.warmup; w++)
+                runBenchTrial(name, size, options.seed, seconds);
+            vector<double> nsPerOp;
+            long long ops = 0;
+            bool measured = resetPeakResident();
+            long casePeakKb = 0;
+            for (int t = 0; t < options.trials; t++)
+            {
+                ops = runBenchTrial(name, size, options.seed, seconds);
+                nsPerOp.push_back(ops > 0 ? seconds * 1e9 / ops : 0);
+            }
+            if (measured)
+            {
+                casePeakKb = peakResidentKb();
+                runPeakKb = max(runPeakKb, casePeakKb);
+            }
+            sort(nsPerOp.begin(), nsPerOp.end());
+            double median = nsPerOp[nsPerOp.size() / 2];
+            out << (first ? "\n" : ",\n") << "    {\"case\": \"" << name << "\", \"size\": " << size << ", \"ops\": " << ops
+                << ", \"ns_per_op\": " << median << ", \"min_ns_per_op\": " << nsPerOp.front()
+                << ", \"ops_per_sec\": " << (median > 0 ? 1e9 / median : 0) << ", \"peak_rss_kb\": " << casePeakKb << "}" << flush;
+            first = false;
+        }
+    out << "\n  ],\n  \"peak_rss_kb\": " << max(runPeakKb, peakResidentKb()) << "\n}" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 3 && string(argv[1]) == "--decode-trace")
+        return decodeTrace(argv[2], argc >= 4 && string(argv[3]) == "--csv") ? 0 : 1;
+
+    string batchPath, tracePath, restorePath;
+    string statsPath;
+    int statsInterval = 1000;
+    bool bench = false;
+    BenchOptions benchOptions;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        bool valid = true;
+        if (arg == "--batch" && i + 1 < argc)
+            batchPath = argv[++i];
+        else if (arg == "--trace" && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (arg == "--restore" && i + 1 < argc)
+            restorePath = argv[++i];
+        else if (arg == "--stats" && i + 1 < argc)
+            statsPath = argv[++i];
+        else if (arg == "--stats-interval" && i + 1 < argc)
+            valid = (statsInterval = atoi(argv[++i])) > 0;
+        else if (arg == "--bench")
+            bench = true;
+        else if (arg == "--sizes" && i + 1 < argc)
+        {
+            istringstream items(argv[++i]);
+            string item;
+            benchOptions.sizes.clear();
+            while (getline(items, item, ','))
+                if (atoi(item.c_str()) > 0)
+                    benchOptions.sizes.push_back(atoi(item.c_str()));
+                else
+                    valid = false;
+            valid = valid && !benchOptions.sizes.empty();
+        }
+        else if (arg == "--cases" && i + 1 < argc)
+        {
+            istringstream items(argv[++i]);
+            string item;
+            benchOptions.cases.clear();
+            while (getline(items, item, ','))
+                if (find(BENCH_CASES, BENCH_CASES + BENCH_CASE_COUNT, item) != BENCH_CASES + BENCH_CASE_COUNT)
+                    benchOptions.cases.push_back(item);
+                else
+                    valid = false;
+            valid = valid && !benchOptions.cases.empty();
+        }
+        else if (arg == "--trials" && i + 1 < argc)
+            valid = (benchOptions.trials = atoi(argv[++i])) > 0;
+        else if (arg == "--warmup" && i + 1 < argc)
+            valid = (benchOptions.warmup = atoi(argv[++i])) >= 0;
+        else if (arg == "--seed" && i + 1 < argc)
+            benchOptions.seed = strtoull(argv[++i], nullptr, 10);
+        else
+            valid = false;
+        if (!valid)
+        {
+            cerr << "Usage: " << argv[0] << " [--restore <snapshot>] [--batch <workload file|->] [--trace <file>] [--stats <file> [--stats-interval <ms>]]" << endl;
+            cerr << "       " << argv[0] << " --decode-trace <file> [--csv]" << endl;
+            cerr << "       " << argv[0] << " --bench [--sizes N,...] [--cases churn,fcfs,priority,sjf,rr,mlfq,lottery,stride,srtf,edf,transitions,lru] [--trials N] [--warmup N] [--seed S]" << endl;
+            return 1;
+        }
+    }
+
+    if (bench)
+    {
+        runBenchmarks(benchOptions, cout);
+        return 0;
+    }
+
+    ProcessManager pm;
+    pm.seedWorkload((uint64_t)time(0));
+    string restoreError;
+    if (!restorePath.empty() && !pm.restoreSnapshot(restorePath, restoreError))
+    {
+        cerr << "Unable to restore: " << restoreError << endl;
+        return 1;
+    }
+    if (!tracePath.empty() && !pm.startTrace(tracePath))
+    {
+        cerr << "Unable to open trace file " << tracePath << endl;
+        return 1;
+    }
+    if (!statsPath.empty() && !pm.startStatsDump(statsPath, statsInterval))
+    {
+        cerr << "Unable to start stats dump to " << statsPath << endl;
+        return 1;
+    }
+
+    if (!batchPath.empty())
+    {
+        pm.setConsoleOutput(false);
+        if (batchPath == "-")
+            return runBatch(pm, cin, cout) == 0 ? 0 : 1;
+        ifstream workload(batchPath.c_str());
+        if (!workload)
+        {
+            cerr << "Unable to open workload file " << batchPath << endl;
+            return 1;
+        }
+        return runBatch(pm, workload, cout) == 0 ? 0 : 1;
+    }
+
+    while (true)
+    {
+        cout << "Main Menu:" << endl;
+        cout << "1. Process Management" << endl;
+        cout << "2. Memory Management" << endl;
+        cout << "3. Automatically Add Processes" << endl;
+        cout << "4. Queue Display Options" << endl;
+        cout << "5. Exit" << endl;
+        int choice = pm.getValidatedChoice(1, 5);
+
+        switch (choice)
+        {
+        case 1:
+        {
+            while (true)
+            {
+                cout << "Process Management Menu:" << endl;
+                cout << "1. Create a process" << endl;
+                cout << "2. Destroy a process" << endl;
+                cout << "3. Suspend a process" << endl;
+                cout << "4. Resume a process" << endl;
+                cout << "5. Block a process" << endl;
+                cout << "6. Wake up a process" << endl;
+                cout << "7. Dispatch a process" << endl;
+                cout << "8. Change process priority" << endl;
+                cout << "9. Process communication" << endl;
+                cout << "10. First-Come-First-Serve (FCFS) Scheduling" << endl;
+                cout << "11. Priority Scheduling" << endl;
+                cout << "12. Shortest Job First (SJF) Scheduling" << endl;
+                cout << "13. Round-Robin (RR) Scheduling" << endl;
+                cout << "14. Multilevel Queue Scheduling" << endl;
+                cout << "15. Drain Ready Queue (FCFS/Priority/SJF/SRTF/EDF)" << endl;
+                cout << "16. Simulate Full Run" << endl;
+                cout << "17. Set Round-Robin Time Quantum" << endl;
+                cout << "18. Round-Robin Quantum Trade-off" << endl;
+                cout << "19. Multilevel Feedback Queue Scheduling" << endl;
+                cout << "20. Configure Multilevel Feedback Queue" << endl;
+                cout << "21. Set CPU Affinity" << endl;
+                cout << "22. Simulate Multi-Core Run" << endl;
+                cout << "23. Destroy All Processes" << endl;
+                cout << "24. Receive a Message" << endl;
+                cout << "25. Lottery Scheduling" << endl;
+                cout << "26. Stride Scheduling" << endl;
+                cout << "27. Shortest Remaining Time First (SRTF) Scheduling" << endl;
+                cout << "28. Earliest Deadline First (EDF) Scheduling" << endl;
+                cout << "29. Back to Main Menu" << endl;
+                int pmChoice = pm.getValidatedChoice(1, 29);
+
+                if (pmChoice == 1)
+                {
+                    int numProcesses;
+                    cout << "Enter number of processes: ";
+                    cin >> numProcesses;
+                    pm.createMultipleProcesses(numProcesses);
+                    pm.displayAll();
+                }
+                else if (pmChoice == 2)
+                {
+                    int pid = pm.getValidatedProcessID();
+                    pm.destroyProcess(pid);
+                    pm.displayAll();
+                }
+                else if (pmChoice == 3)
+                {
+                    int pid = pm.getValidatedProcessID();
+                    pm.suspendProcess(pid);
+                    pm.displayAll();
+                }
+                else if (pmChoice == 4)
+                {
+                    pm.resumeProcess();
+                    pm.displayAll();
+                }
+                else if (pmChoice == 5)
+                {
+                    int pid = pm.getValidatedProcessID();
+                    pm.blockProcess(pid);
+                    pm.displayAll();
+                }
+                else if (pmChoice == 6)
+                {
+                    pm.wakeupProcess();
+                    pm.displayAll();
+                }
+                else if (pmChoice == 7)
+                {
+                    int pid = pm.getValidatedProcessID();
+                    pm.dispatchProcess(pid);
+                    pm.displayAll();
+                }
+                else if (pmChoice == 8)
+                {
+                    int pid = pm.getValidatedProcessID();
+                    int newPriority;
+                    cout << "Enter new priority: ";
+                    cin >> newPriority;
+                    pm.changeProcessPriority(pid, newPriority);
+                    pm.displayAll();
+                }
+                else if (pmChoice == 9)
+                {
+                    int senderPid = pm.getValidatedProcessID();
+                    int receiverPid = pm.getValidatedProcessID();
+                    string message;
+                    cout << "Enter message to send: ";
+                    cin.ignore(); // To clear the newline left in the input buffer
+                    getline(cin, message);
+                    pm.processCommunication(senderPid, receiverPid, message);
+                    pm.displayAll();
+                }
+                else if (pmChoice == 10)
+                {
+                    pm.fcfs();
+                    pm.displayAll();
+                }
+                else if (pmChoice == 11)
+                {
+                    pm.priorityScheduling();
+                    pm.displayAll();
+                }
+                else if (pmChoice == 12)
+                {
+                    pm.sjf();
+                    pm.displayAll();
+                }
+                else if (pmChoice == 13)
+                {
+                    pm.roundRobin();
+                    pm.displayAll();
+                }
+                else if (pmChoice == 14)
+                {
+                    pm.multilevelQueueScheduling();
+                    pm.displayAll();
+                }
+                else if (pmChoice == 15)
+                {
+                    cout << "1. FCFS  2. Priority  3. SJF  4. SRTF  5. EDF" << endl;
+                    int policy = pm.getValidatedChoice(1, 5);
+                    if (policy == 1)
+                        pm.fcfs(true);
+                    else if (policy == 2)
+                        pm.priorityScheduling(true);
+                    else if (policy == 3)
+                        pm.sjf(true);
+                    else if (policy == 4)
+                        pm.srtf(true);
+                    else
+                        pm.edf(true);
+                    pm.displayAll();
+                }
+                else if (pmChoice == 16)
+                {
+                    cout << "1. FCFS  2. Priority  3. SJF  4. Round-Robin  5. Multilevel Queue  6. Multilevel Feedback Queue  7. Lottery  8. Stride  9. SRTF  10. EDF" << endl;
+                    SimulationOptions options = pm.simulationOptions((SchedulingPolicy)(pm.getValidatedChoice(1, POLICY_COUNT) - 1));
+                    SimulationResult result = pm.simulateScheduling(options);
+                    pm.displaySimulation(result, 50);
+                }
+                else if (pmChoice == 17)
+                {
+                    int quantum;
+                    cout << "Enter time quantum (0 for adaptive): ";
+                    cin >> quantum;
+                    pm.setTimeQuantum(quantum);
+                }
+                else if (pmChoice == 18)
+                {
+                    int quanta[] = {1, 2, 5, 10, 20, 50, 100, 0};
+                    vector<int> ladder(quanta, quanta + sizeof(quanta) / sizeof(quanta[0]));
+                    pm.displayQuantumTradeoff(ladder, pm.quantumTradeoff(ladder));
+                }
+                else if (pmChoice == 19)
+                {
+                    pm.multilevelFeedbackScheduling();
+                    pm.displayAll();
+                }
+                else if (pmChoice == 20)
+                {
+                    int levels, baseQuantum, boost;
+                    cout << "Enter number of levels: ";
+                    cin >> levels;
+                    cout << "Enter top-level time quantum: ";
+                    cin >> baseQuantum;
+                    cout << "Enter boost interval (0 to disable): ";
+                    cin >> boost;
+                    pm.configureFeedbackQueue(levels, baseQuantum, boost);
+                }
+                else if (pmChoice == 21)
+                {
+                    int pid = pm.getValidatedProcessID();
+                    int cpu;
+                    cout << "Enter CPU (-1 for any): ";
+                    cin >> cpu;
+                    pm.setProcessAffinity(pid, cpu);
+                }
+                else if (pmChoice == 22)
+                {
+                    SmpOptions options;
+                    cout << "Enter number of CPUs: ";
+                    cin >> options.cpus;
+                    cout << "1. Push migration and work stealing  2. Push migration  3. Work stealing  4. No balancing" << endl;
+                    int balancing = pm.getValidatedChoice(1, 4);
+                    options.pushMigration = balancing == 1 || balancing == 2;
+                    options.workStealing = balancing == 1 || balancing == 3;
+                    options.timeQuantum = max(1, pm.getTimeQuantum());
+                    options.threads = thread::hardware_concurrency();
+                    pm.displayMultiCore(pm.simulateMultiCore(options), 64);
+                }
+                else if (pmChoice == 23)
+                {
+                    pm.destroyAllProcesses();
+                    pm.displayAll();
+                }
+                else if (pmChoice == 24)
+                {
+                    int pid = pm.getValidatedProcessID();
+                    Message message;
+                    ReceiveStatus status = pm.receiveMessage(pid, message);
+                    if (status == RECEIVE_OK)
+                        cout << "Process " << pid << " received from Process " << message.sender << ": " << message.payload << endl;
+                    else if (status == RECEIVE_BLOCKED)
+                        cout << "Mailbox empty; Process " << pid << " is blocked until a message arrives." << endl;
+                    else
+                        cout << "Process " << pid << " must be ready or running to receive." << endl;
+                    pm.displayAll();
+                }
+                else if (pmChoice == 25)
+                {
+                    pm.lotteryScheduling();
+                    pm.displayAll();
+                }
+                else if (pmChoice == 26)
+                {
+                    pm.strideScheduling();
+                    pm.displayAll();
+                }
+                else if (pmChoice == 27)
+                {
+                    pm.srtf();
+                    pm.displayAll();
+                }
+                else if (pmChoice == 28)
+                {
+                    pm.edf();
+                    pm.displayAll();
+                }
+                else if (pmChoice == 29)
+                {
+                    break;
+                }
+            }
+            break;
+        }
+        case 2:
+        {
+            while (true)
+            {
+                cout << "Memory Management Menu:" << endl;
+                cout << "1. Set Page Size" << endl;
+                cout << "2. Calculate Pages" << endl;
+                cout << "3. Perform Paging" << endl;
+                cout << "4. Perform LRU" << endl;
+                cout << "5. Compare Page Replacement Policies" << endl;
+                cout << "6. LRU Miss-Ratio Curve" << endl;
+                cout << "7. Configure Virtual Memory" << endl;
+                cout << "8. Translate Address" << endl;
+                cout << "9. Run Memory Access Workload" << endl;
+                cout << "10. Back to Main Menu" << endl;
+                int mmChoice = pm.getValidatedChoice(1, 10);
+
+                if (mmChoice == 1)
+                {
+                    int pid = pm.getValidatedProcessID();
+                    int pageSize;
+                    cout << "Enter Page Size: ";
+                    cin >> pageSize;
+                    pm.setPageSize(pid, pageSize);
+                }
+                else if (mmChoice == 2)
+                {
+                    int pid = pm.getValidatedProcessID();
+                    int memoryAllocated, processSize;
+                    cout << "Enter Memory Size: ";
+                    cin >> memoryAllocated;
+                    cout << "Enter Process Size: ";
+                    cin >> processSize;
+                    pm.calculatePages(pid, memoryAllocated, processSize);
+                }
+                else if (mmChoice == 3)
+                {
+                    int pid = pm.getValidatedProcessID();
+                    pm.performPaging(pid);
+                }
+                else if (mmChoice == 4)
+                {
+                    int numFrames;
+                    int numReferences;
+                    vector<int> pageReferences;
+                    cout << "Enter number of frames: ";
+                    cin >> numFrames;
+                    cout << "Enter number of page references (0 to read a trace file): ";
+                    cin >> numReferences;
+                    if (numReferences <= 0)
+                    {
+                        string path;
+                        cout << "Enter trace file path: ";
+                        cin >> path;
+                        pm.performLRUFromTrace(numFrames, path);
+                        continue;
+                    }
+                    pageReferences.resize(numReferences);
+                    cout << "Enter page references: ";
+                    for (int i = 0; i < numReferences; i++)
+                        cin >> pageReferences[i];
+                    pm.performLRU(numFrames, pageReferences);
+                }
+                else if (mmChoice == 5)
+                {
+                    int numFrames;
+                    int numReferences;
+                    vector<int> pageReferences;
+                    cout << "Enter number of frames: ";
+                    cin >> numFrames;
+                    cout << "Enter number of page references: ";
+                    cin >> numReferences;
+                    pageReferences.resize(numReferences);
+                    cout << "Enter page references: ";
+                    for (int i = 0; i < numReferences; i++)
+                        cin >> pageReferences[i];
+                    pm.compareReplacementPolicies(numFrames, pageReferences);
+                }
+                else if (mmChoice == 6)
+                {
+                    int maxFrames;
+                    int numReferences;
+                    double samplingRate;
+                    string csvPath;
+                    vector<int> pageReferences;
+                    cout << "Enter maximum number of frames: ";
+                    cin >> maxFrames;
+                    cout << "Enter number of page references: ";
+                    cin >> numReferences;
+                    pageReferences.resize(numReferences);
+                    cout << "Enter page references: ";
+                    for (int i = 0; i < numReferences; i++)
+                        cin >> pageReferences[i];
+                    cout << "Enter sampling rate (1 for exact): ";
+                    cin >> samplingRate;
+                    cout << "Enter CSV output file (- for none): ";
+                    cin >> csvPath;
+                    pm.missRatioCurve(maxFrames, pageReferences, samplingRate, csvPath == "-" ? "" : csvPath);
+                }
+                else if (mmChoice == 7)
+                {
+                    int frames, pageSize, tlbSets, tlbWays, addressBits;
+                    cout << "Enter number of physical frames: ";
+                    cin >> frames;
+                    cout << "Enter page size (power of two): ";
+                    cin >> pageSize;
+                    cout << "Enter TLB sets and ways: ";
+                    cin >> tlbSets >> tlbWays;
+                    cout << "Enter virtual address bits: ";
+                    cin >> addressBits;
+                    pm.configureMemory(frames, pageSize, tlbSets, tlbWays, addressBits);
+                }
+                else if (mmChoice == 8)
+                {
+                    int pid = pm.getValidatedProcessID();
+                    unsigned long long vaddr;
+                    cout << "Enter virtual address: ";
+                    cin >> vaddr;
+                    pm.translateAddress(pid, vaddr);
+                }
+                else if (mmChoice == 9)
+                {
+                    int pid = pm.getValidatedProcessID();
+                    long long count;
+                    unsigned long long pages;
+                    double seconds;
+                    cout << "Enter number of accesses: ";
+                    cin >> count;
+                    cout << "Enter number of distinct pages to touch: ";
+                    cin >> pages;
+                    pm.runMemoryWorkload(pid, count, pages, (uint64_t)time(0), seconds);
+                }
+                else if (mmChoice == 10)
+                {
+                    break;
+                }
+            }
+            break;
+        }
+        case 3:
+        {
+            int numProcesses;
+            cout << "Enter number of processes to add: ";
+            cin >> numProcesses;
+            pm.createMultipleProcesses(numProcesses);
+            pm.displayAll();
+            break;
+        }
+        case 4:
+        {
+            DisplayOptions options = pm.getDisplayOptions();
+            cout << "1. All rows" << endl;
+            cout << "2. One page of rows per queue" << endl;
+            cout << "3. Queue summaries only" << endl;
+            cout << "4. Changes since the last view" << endl;
+            options.mode = (DisplayMode)(pm.getValidatedChoice(1, 4) - 1);
+            if (options.mode == DISPLAY_PAGE || options.mode == DISPLAY_DIFF)
+            {
+                cout << "Enter rows per page: ";
+                cin >> options.rows;
+                options.rows = max(1, options.rows);
+            }
+            if (options.mode == DISPLAY_PAGE)
+            {
+                cout << "Enter page number (0 = first): ";
+                cin >> options.page;
+                options.page = max(0, options.page);
+            }
+            pm.setDisplayOptions(options);
+            pm.displayAll();
+            break;
+        }
+        case 5:
+            cout << "Exit" << endl;
+            return 0;
+        }
+    }
+}